@@ -0,0 +1,13 @@
+#include "Batch.h"
+#include "Logger.h"
+
+int main(int argc, char** argv){
+
+    // only warnings and errors, -v prints also info messages
+    LOG::LEVEL = LogLevel::WARN;
+    LOG::PRINT_INFO_LEVEL = false;
+
+    Batch batch;
+
+    return batch.start(argc, argv);
+}
@@ -5,7 +5,7 @@
 #include "VertexBuffer.h"
 #include "VertexArray.h"
 #include "Shader.h"
-#include "Vector2f.h"
+#include "Vector2.h"
 #include <vector>
 
 
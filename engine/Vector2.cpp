@@ -0,0 +1,34 @@
+#include "Vector2.h"
+#include <math.h>
+
+template <typename T>
+bool Vector2<T>::operator==(const Vector2<T>& equal) const{
+    return AreDoublesEqual(x, equal.x) && AreDoublesEqual(y, equal.y);
+}
+
+template <typename T>
+const double Vector2<T>::TOLERANCE = 1.0E-5;
+
+template <typename T>
+const double Vector2<T>::SOFT_TOLERANCE = 1.0E-3;
+
+template <typename T>
+bool Vector2<T>::AreDoublesEqual(double a, double b, double tolerance){
+    return abs(a - b) < tolerance;
+}
+
+template <typename T>
+bool Vector2<T>::IsFirstDoubleGreater(double a, double b, double tolerance){
+    return a > b + tolerance;
+}
+
+template <typename T>
+std::ostream& operator<< (std::ostream& ostrem, const Vector2<T>& point){
+    return ostrem << "x: " << point.x << " y: " << point.y;
+}
+
+template class Vector2<float>;
+template class Vector2<double>;
+
+template std::ostream& operator<< (std::ostream& ostrem, const Vector2<float>& point);
+template std::ostream& operator<< (std::ostream& ostrem, const Vector2<double>& point);
@@ -0,0 +1,90 @@
+#ifndef VECTOR2_H
+#define VECTOR2_H
+
+#include <iostream>
+#include <type_traits>
+
+
+// point of the plane with coordinates of type T, float or double
+// copy and assignment are the ones of the compiler, so the points are trivially copyable
+// and a vector of points is copied and moved as plain memory
+template <typename T>
+class Vector2{
+
+public:
+    T x;
+    T y;
+
+    constexpr Vector2() : x{0}, y{0} {}
+    constexpr Vector2(T _x, T _y) : x{_x}, y{_y} {}
+    // from a point of the other precision, it has to be asked because from double to float it is rounded
+    template <typename U>
+    explicit constexpr Vector2(const Vector2<U>& other) : x{(T)other.x}, y{(T)other.y} {}
+
+    // equal inside Vector2::TOLERANCE
+    bool operator==(const Vector2& equal) const;
+
+    constexpr Vector2 operator+(const Vector2& other) const{
+        return {x + other.x, y + other.y};
+    }
+
+    constexpr Vector2 operator-(const Vector2& other) const{
+        return {x - other.x, y - other.y};
+    }
+
+    constexpr Vector2& operator+=(const Vector2& other){
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+
+    constexpr Vector2& operator-=(const Vector2& other){
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
+
+    // the products are computed in T and returned as double
+    constexpr double dot(const Vector2& other) const{
+        return x * other.x + y * other.y;
+    }
+
+    constexpr double cross(const Vector2& other) const{
+        return x * other.y - y * other.x;
+    }
+
+    constexpr double normSquared() const{
+        return x * x + y * y;
+    }
+
+    static const double TOLERANCE;
+    static const double SOFT_TOLERANCE;
+
+    static bool AreDoublesEqual(double a, double b, double tolerance = Vector2::TOLERANCE);
+    static bool IsFirstDoubleGreater(double a, double b, double tolerance = Vector2::TOLERANCE);
+};
+
+template <typename T>
+std::ostream& operator<< (std::ostream& ostrem, const Vector2<T>& point);
+
+// the functions that are not in the header are compiled in Vector2.cpp just for these two
+extern template class Vector2<float>;
+extern template class Vector2<double>;
+
+using Vector2f = Vector2<float>;
+using Vector2d = Vector2<double>;
+
+static_assert(std::is_trivially_copyable<Vector2f>::value, "Vector2f has to be copied as plain memory");
+static_assert(std::is_trivially_copyable<Vector2d>::value, "Vector2d has to be copied as plain memory");
+
+// the geometry of polygon_core (Polygon, Intersector, Element, Mesh...) is computed in Real,
+// float by default and double when the library is built with -DPOLYGON_DOUBLE_PRECISION=ON
+// the renderer always draws Vector2f
+#if defined(POLYGON_DOUBLE_PRECISION)
+using Real = double;
+#else
+using Real = float;
+#endif
+using Vector2r = Vector2<Real>;
+
+#endif // VECTOR2_H
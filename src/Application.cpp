@@ -1,5 +1,6 @@
 #include "Application.h"
-#include "Intersector.h"
+#include "Predicates.h"
+#include "PolygonValidator.h"
 #include "Logger.h"
 #include <fstream>
 #include <sstream>
@@ -21,12 +22,9 @@ unsigned int Application::getNumberVertices() const{
 bool Application::addVertex(const Vector2f &vertex){
     unsigned int numberVertices = getNumberVertices();
     if (numberVertices >= 2){
-        Intersector inter;
-        inter.setSegment1(vertex, vertices[numberVertices - 1]);
+        // the new side can not cross the sides already drawn
         for (unsigned int i = 0; i < numberVertices - 1; i++){
-            inter.setSegment2(vertices[i], vertices[i + 1]);
-            IntersectionType type = inter.calculateIntersection();
-            if (type == IntersectionType::InsideSegment){
+            if (Predicates::SegmentsCross(vertex, vertices[numberVertices - 1], vertices[i], vertices[i + 1])){
                 return false;
             }
         }
@@ -49,14 +47,14 @@ bool Application::closePolygon(){
     if (numberVertices < 3){
         return false;
     }
-    Intersector inter;
-    inter.setSegment1(vertices[numberVertices - 1], vertices[0]);
-    for (unsigned int i = 0; i < numberVertices - 1; i++){
-        inter.setSegment2(vertices[i], vertices[i + 1]);
-        IntersectionType type = inter.calculateIntersection();
-        if (type == IntersectionType::InsideSegment){
-            return false;
-        }
+    // addVertex checked only crossings of the sides drawn, the whole polygon is checked once with the closing side
+    // (also a vertex on another side or a side going back on the one before)
+    unsigned int firstEdge;
+    unsigned int secondEdge;
+    PolygonDefect defect = PolygonValidator::FindDefect(vertices, indices, firstEdge, secondEdge);
+    if (defect != PolygonDefect::None){
+        LOG(LogLevel::WARN) << "polygon is not simple: " << defect << " (edges " << firstEdge << " and " << secondEdge << ")";
+        return false;
     }
     verticesIndicesLoaded = true;
     return true;
@@ -100,6 +98,7 @@ void Application::createMainPolygon(){
         listIndices.push_back(indices[i]);
     }
     mainPolygon.setBody(vertices, listIndices);
+    mainPolygon.createEdgeTree();
 }
 
 
@@ -112,7 +111,7 @@ void Application::cutMainPolygon(bool alsoSegmentPoints){
     LOG(LogLevel::INFO) << "End of cutting";
 }
 
-const std::vector<std::shared_ptr<std::vector<unsigned int>>>& Application::getPolygonsIndices() const{
+const PolygonSet& Application::getPolygonsIndices() const{
     return polygonsIndices;
 }
 
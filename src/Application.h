@@ -2,7 +2,7 @@
 #define APPLICATION_H
 
 #include "Polygon.h"
-#include "Vector2f.h"
+#include "Vector2.h"
 #include <vector>
 #include <iostream>
 
@@ -33,7 +33,7 @@ public:
     const Polygon& getPolygon() const;
     void createMainPolygon();
     void cutMainPolygon(bool alsoSegmentPoints = false);
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& getPolygonsIndices() const;
+    const PolygonSet& getPolygonsIndices() const;
 
     void setVerticesIndicesLoaded();
     void setSegmentLoaded();
@@ -72,7 +72,7 @@ private:
     std::vector<unsigned int> indices;
     Polygon mainPolygon;
     std::vector<Vector2f> segmentPoints;
-    std::vector<std::shared_ptr<std::vector<unsigned int>>> polygonsIndices;
+    PolygonSet polygonsIndices;
 
     std::vector<Vector2f> boxVertices;
     std::vector<Vector2f> defaultVertices;
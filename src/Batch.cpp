@@ -0,0 +1,243 @@
+#include "Batch.h"
+#include "Logger.h"
+#include "Loader.h"
+#include "Polygon.h"
+#include "Element.h"
+#include "Mesh.h"
+#include <filesystem>
+#include <sstream>
+
+Batch::Batch() : mode{ModeBatch::Cut}, numberX{3}, numberY{3}, numberThreads{1}, concave{false}, alsoSegmentPoints{false},
+                 elementFromPolygon{false}, fixedPoint{false} {}
+
+int Batch::start(int argc, char** argv){
+    if (!parseArguments(argc, argv)){
+        PrintUsage();
+        return 2;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(outputDirectory, error);
+    if (error){
+        LOG(LogLevel::ERROR) << "failed to create output directory " << outputDirectory << ": " << error.message();
+        return 2;
+    }
+
+    std::vector<Vector2r> verticesBorder;
+    if (mode == ModeBatch::Mesh){
+        std::vector<Index> indicesBorder;
+        int numberVertices = Loader::GetNumberVerticesFromFile(borderFileName);
+        if (numberVertices <= 0){
+            return 2;
+        }
+        bool loadIndices = Loader::SearchInFile(borderFileName, "indices", false) > 0;
+        std::vector<Vector2r> loadedBorder;
+        if (Loader::LoadVerticesIndicesFromFile(loadedBorder, indicesBorder, borderFileName, numberVertices, loadIndices) <= 0){
+            return 2;
+        }
+        // Mesh takes the border vertices already in order
+        for (unsigned int i = 0; i < indicesBorder.size(); i++){
+            verticesBorder.push_back(loadedBorder[indicesBorder[i]]);
+        }
+    }
+
+    unsigned int numberFailed = 0;
+    unsigned int numberFiles = inputFileNames.size();
+    for (unsigned int i = 0; i < numberFiles; i++){
+        bool done = mode == ModeBatch::Cut ? cutPolygonFile(inputFileNames[i]) : cutMeshFile(inputFileNames[i], verticesBorder);
+        if (!done){
+            LOG(LogLevel::ERROR) << "failed to process " << inputFileNames[i];
+            numberFailed++;
+        }
+    }
+
+    std::cout << "Processed " << numberFiles - numberFailed << " of " << numberFiles << " files\n";
+
+    return numberFailed == 0 ? 0 : 1;
+}
+
+void Batch::PrintUsage(){
+    std::cerr << "Usage:\n";
+    std::cerr << "  polygon-batch cut  -o <output directory> [-s <segment file>] [--segment-points] <polygon files...>\n";
+    std::cerr << "  polygon-batch mesh -o <output directory> -b <border file> [-x <number>] [-y <number>]\n";
+    std::cerr << "                     [-j <number>] [--concave] [--create-element] [--fixed-point]\n";
+    std::cerr << "                     <element files...>\n";
+    std::cerr << "\n";
+    std::cerr << "Options:\n";
+    std::cerr << "  -o <directory>      directory where results are saved, one file for each input file\n";
+    std::cerr << "  -s <file>           load the segment from this file instead of the polygon file\n";
+    std::cerr << "  --segment-points    also add segment points if inside polygon\n";
+    std::cerr << "  -b <file>           file with the vertices (and optionally indices) of the border\n";
+    std::cerr << "  -x, -y <number>     number of elements on the x and y axis (default 3)\n";
+    std::cerr << "  -j <number>         threads used to cut the elements, 0 uses all the cores (default 1)\n";
+    std::cerr << "  --concave           clip the elements with the border also if it is convex\n";
+    std::cerr << "  --create-element    input files are polygons, the element is created from them\n";
+    std::cerr << "  --fixed-point       snap the border, the elements and the crossing points to a fixed grid\n";
+    std::cerr << "  -v                  print info messages\n";
+}
+
+bool Batch::parseArguments(int argc, char** argv){
+    if (argc < 2){
+        return false;
+    }
+
+    std::string modeString = argv[1];
+    if (modeString == "cut"){
+        mode = ModeBatch::Cut;
+    } else if (modeString == "mesh"){
+        mode = ModeBatch::Mesh;
+    } else{
+        LOG(LogLevel::ERROR) << "unknown mode " << modeString;
+        return false;
+    }
+
+    for (int i = 2; i < argc; i++){
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "-o" && hasValue){
+            outputDirectory = argv[++i];
+        } else if (argument == "-s" && hasValue){
+            segmentFileName = argv[++i];
+        } else if (argument == "-b" && hasValue){
+            borderFileName = argv[++i];
+        } else if ((argument == "-x" || argument == "-y") && hasValue){
+            std::stringstream convert;
+            unsigned int number = 0;
+            convert.str(argv[++i]);
+            convert >> number;
+            if (convert.fail() || number == 0){
+                LOG(LogLevel::ERROR) << "number of elements should be a number greather than 0";
+                return false;
+            }
+            if (argument == "-x"){
+                numberX = number;
+            } else{
+                numberY = number;
+            }
+        } else if (argument == "-j" && hasValue){
+            std::stringstream convert;
+            convert.str(argv[++i]);
+            convert >> numberThreads;
+            if (convert.fail()){
+                LOG(LogLevel::ERROR) << "number of threads should be a number";
+                return false;
+            }
+        } else if (argument == "--concave"){
+            concave = true;
+        } else if (argument == "--segment-points"){
+            alsoSegmentPoints = true;
+        } else if (argument == "--create-element"){
+            elementFromPolygon = true;
+        } else if (argument == "--fixed-point"){
+            fixedPoint = true;
+        } else if (argument == "-v"){
+            LOG::LEVEL = LogLevel::INFO;
+        } else if (argument.size() > 1 && argument[0] == '-'){
+            LOG(LogLevel::ERROR) << "unknown option or missing value " << argument;
+            return false;
+        } else{
+            inputFileNames.push_back(argument);
+        }
+    }
+
+    if (outputDirectory.empty()){
+        LOG(LogLevel::ERROR) << "output directory is not set";
+        return false;
+    }
+    if (mode == ModeBatch::Mesh && borderFileName.empty()){
+        LOG(LogLevel::ERROR) << "border file is not set";
+        return false;
+    }
+    if (inputFileNames.empty()){
+        LOG(LogLevel::ERROR) << "no input files";
+        return false;
+    }
+    return true;
+}
+
+bool Batch::cutPolygonFile(const std::string& fileName){
+    int numberVertices = Loader::GetNumberVerticesFromFile(fileName);
+    if (numberVertices <= 0){
+        return false;
+    }
+
+    std::vector<Vector2r> vertices;
+    std::vector<Index> indices;
+    bool loadIndices = Loader::SearchInFile(fileName, "indices", false) > 0;
+    if (Loader::LoadVerticesIndicesFromFile(vertices, indices, fileName, numberVertices, loadIndices) <= 0){
+        return false;
+    }
+
+    std::vector<Vector2r> segmentPoints;
+    const std::string& segmentFile = segmentFileName.empty() ? fileName : segmentFileName;
+    if (Loader::LoadSegmentFromFile(segmentPoints, segmentFile) <= 0){
+        return false;
+    }
+
+    Polygon polygon(vertices, indices);
+    polygon.setSegment(segmentPoints[0], segmentPoints[1]);
+    polygon.createNetwork(alsoSegmentPoints);
+    PolygonSet polygonsIndices = polygon.cut();
+    // the points added by the cut need an index too, the error is already written
+    if (polygon.getPoints().size() > PolygonSet::MAX_NUMBER_POINTS){
+        return false;
+    }
+
+    Loader::SavePolygonToFile(polygon.getPoints(), indices, segmentPoints, polygonsIndices, getOutputFileName(fileName));
+    return true;
+}
+
+bool Batch::cutMeshFile(const std::string& fileName, const std::vector<Vector2r>& verticesBorder){
+    int numberVertices = Loader::GetNumberVerticesFromFile(fileName);
+    if (numberVertices <= 0){
+        return false;
+    }
+
+    std::unique_ptr<Element> element;
+    if (elementFromPolygon){
+        std::vector<Vector2r> vertices;
+        std::vector<Index> indices;
+        bool loadIndices = Loader::SearchInFile(fileName, "indices", false) > 0;
+        if (Loader::LoadVerticesIndicesFromFile(vertices, indices, fileName, numberVertices, loadIndices) <= 0){
+            return false;
+        }
+        element = std::make_unique<Element>(vertices, indices);
+        element->createElement();
+    } else{
+        std::vector<Vector2r> vertices;
+        if (Loader::LoadJustVerticesFromFile(vertices, fileName, numberVertices) <= 0){
+            return false;
+        }
+        int numberSmallPolygons = Loader::GetNumberSmallPolygonsFromFile(fileName);
+        if (numberSmallPolygons <= 0){
+            return false;
+        }
+        PolygonSet polygonsIndices;
+        if (Loader::LoadSmallPolygonsIndicesFromFile(polygonsIndices, fileName, numberSmallPolygons) <= 0){
+            return false;
+        }
+        element = std::make_unique<Element>(vertices, polygonsIndices);
+    }
+
+    Real width;
+    Real height;
+    Real xMin;
+    Real yMin;
+    Polygon::createBoundingBoxVariables(verticesBorder, width, height, xMin, yMin);
+
+    Mesh mesh(*element, verticesBorder, numberX, numberY, width / numberX, height / numberY, fixedPoint);
+    mesh.setNumberThreads(numberThreads);
+    std::vector<IndicesElement> indicesElement = concave ? mesh.cutConcave() : mesh.cut();
+    for (const std::shared_ptr<std::vector<Vector2r>>& verticesElement : mesh.getAllVertices()){
+        if (verticesElement->size() > PolygonSet::MAX_NUMBER_POINTS){
+            return false;
+        }
+    }
+
+    Loader::SaveMeshToFile(mesh.getAllVertices(), indicesElement, getOutputFileName(fileName));
+    return true;
+}
+
+std::string Batch::getOutputFileName(const std::string& fileName) const{
+    return (std::filesystem::path(outputDirectory) / std::filesystem::path(fileName).filename()).string();
+}
@@ -0,0 +1,62 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <vector>
+#include <string>
+#include "Vector2.h"
+
+
+enum class ModeBatch{
+    Cut,
+    Mesh
+};
+
+// headless counterpart of Console: it reads everything from the command line and from files,
+// cuts polygons or meshes and saves the results without ever opening a window
+class Batch{
+
+public:
+    Batch();
+
+    Batch(const Batch&)                 = delete;
+    Batch(Batch&&) noexcept             = delete;
+    Batch& operator=(const Batch&)      = delete;
+    Batch& operator=(Batch&&) noexcept  = delete;
+
+    // return: 0 if every input file was processed, 1 if some file failed, 2 if the arguments are wrong
+    int start(int argc, char** argv);
+
+    static void PrintUsage();
+
+private:
+    ModeBatch mode;
+
+    std::string outputDirectory;
+    std::string segmentFileName;
+    std::string borderFileName;
+    std::vector<std::string> inputFileNames;
+
+    unsigned int numberX;
+    unsigned int numberY;
+    // threads used to cut the elements of a mesh, 0 is one for each core
+    unsigned int numberThreads;
+
+    // the elements are cutted with Mesh::cutConcave, clipped with the border also if it is convex
+    bool concave;
+    bool alsoSegmentPoints;
+    // input files of the mesh are polygons and the element is created from them
+    bool elementFromPolygon;
+    // the mesh is computed on the grid of FixedPoint
+    bool fixedPoint;
+
+    // return: true if the arguments are valid
+    bool parseArguments(int argc, char** argv);
+
+    // return: true if the file was cutted and saved
+    bool cutPolygonFile(const std::string& fileName);
+    bool cutMeshFile(const std::string& fileName, const std::vector<Vector2r>& verticesBorder);
+
+    std::string getOutputFileName(const std::string& fileName) const;
+};
+
+#endif // BATCH_H
@@ -145,7 +145,7 @@ void Console::drawNoInput(){
 }
 
 void Console::drawNoInput(const std::vector<Vector2f>& vertices,
-                          const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices){
+                          const PolygonSet& indices){
     while (true){
         if (processWindow()){
             break;
@@ -164,7 +164,7 @@ void Console::drawNoInput(const std::vector<Vector2f>& vertices,
 }
 
 void Console::drawNoInput(const std::vector<std::shared_ptr<std::vector<Vector2f>>>& vertices,
-                          const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices){
+                          const PolygonSet& indices){
     while (true){
         if (processWindow()){
             break;
@@ -228,10 +228,10 @@ void Console::drawNoInput(const std::vector<std::shared_ptr<std::vector<Vector2f
     }
 }
 
-void Console::drawIndices(const std::vector<Vector2f>& vertices, const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices){
+void Console::drawIndices(const std::vector<Vector2f>& vertices, const PolygonSet& indices){
     std::stringstream convert;
     for (unsigned int i = 0; i < indices.size(); i++){
-        const std::vector<unsigned int>& indi = *indices[i];
+        const PolygonView indi = indices[i];
         for (unsigned int l = 0; l < indi.size(); l++){
             unsigned int index = indi[l];
             convert << index;
@@ -562,12 +562,12 @@ void Console::drawCuttedPolygon(){
     renderer->removeLastShape();
     renderer->removeLastShape();
     app.cutMainPolygon(alsoSegmentPoints);
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices = app.getPolygonsIndices();
+    const PolygonSet& polygonsIndices = app.getPolygonsIndices();
 
     LOG::NewLine(LogLevel::INFO);
     LOG(LogLevel::INFO) << "Number of polygons: " << polygonsIndices.size();
     for (unsigned int i = 0; i < polygonsIndices.size(); i++){
-        const std::vector<unsigned int>& indices = *polygonsIndices[i];
+        const std::vector<unsigned int> indices = polygonsIndices[i].toVector();
         {
             LOG log = LOG(LogLevel::INFO);
             for (unsigned int n = 0; n < indices.size(); n++){
@@ -737,10 +737,10 @@ void Console::createElement(Element& element){
     element.createElement();
 
     const std::vector<Vector2f>& points = element.getPoints();
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices = element.getPolygonsIndices();
+    const PolygonSet& polygonsIndices = element.getPolygonsIndices();
 
     for (unsigned int i = 0; i < polygonsIndices.size(); i++){
-        const std::vector<unsigned int>& indices = *polygonsIndices[i];
+        const std::vector<unsigned int> indices = polygonsIndices[i].toVector();
 
     //        Shape* shapeNuova = new LinesPointIndices(app.getPolygon().getPoints(), indices);
         std::vector<float> color = Renderer::getNextColor();
@@ -782,14 +782,14 @@ void Console::createMesh(Element& element){
 
     const unsigned int numberElements = mesh.getNumberElements();
 
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices = mesh.getIndices();
+    const PolygonSet& indices = mesh.getIndices();
     unsigned int numberPolygons = mesh.getNumberPolygons();
 
     for (unsigned int q = 0; q < numberElements; q++){
         const std::vector<Vector2f>& vertices = mesh.getVertices(q);
         std::vector<float> nextColor = Renderer::getNextColor();
         for (unsigned int i = 0; i < numberPolygons; i++){
-            Shape* shapeNuova = new Shape(vertices, *indices[i], GeometricPrimitive::LinePointClosed,
+            Shape* shapeNuova = new Shape(vertices, indices[i].toVector(), GeometricPrimitive::LinePointClosed,
                                           nextColor[0], nextColor[1], nextColor[2]);
             renderer->addShape(shapeNuova);
         }
@@ -805,27 +805,27 @@ void Console::createMesh(Element& element){
 //    for (unsigned int i = 1; i < 2; i++){
     for (unsigned int i = 0; i < indicesElement.size(); i++){
         const std::vector<Vector2f>& vertices = mesh.getVertices(i);
-        const std::vector<std::shared_ptr<std::vector<unsigned int>>>& insideIndices = *indicesElement[i].indicesInside;
-        const std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsideIndices = *indicesElement[i].indicesOutside;
+        const PolygonSet& insideIndices = *indicesElement[i].indicesInside;
+        const PolygonSet& outsideIndices = *indicesElement[i].indicesOutside;
         std::cout << "Inside:\n";
         for (unsigned int n = 0; n < insideIndices.size(); n++){
-            std::vector<unsigned int>& indi = *insideIndices[n];
+            const PolygonView indi = insideIndices[n];
             for (unsigned int il = 0; il < indi.size(); il++){
                 std::cout << indi[il] << " ";
             }
             std::cout << "\n";
-            Shape* shapeNuova = new Shape(vertices, *insideIndices[n], GeometricPrimitive::LinePointClosed,
+            Shape* shapeNuova = new Shape(vertices, indi.toVector(), GeometricPrimitive::LinePointClosed,
                                           colorInside[0], colorInside[1], colorInside[2]);
             renderer->addShape(shapeNuova);
         }
         std::cout << "Outside:\n";
         for (unsigned int n = 0; n < outsideIndices.size(); n++){
-            std::vector<unsigned int>& indi = *outsideIndices[n];
+            const PolygonView indi = outsideIndices[n];
             for (unsigned int il = 0; il < indi.size(); il++){
                 std::cout << indi[il] << " ";
             }
             std::cout << "\n";
-            Shape* shapeNuova = new Shape(vertices, *outsideIndices[n], GeometricPrimitive::LinePointClosed,
+            Shape* shapeNuova = new Shape(vertices, indi.toVector(), GeometricPrimitive::LinePointClosed,
                                           colorOutside[0], colorOutside[1], colorOutside[2]);
             renderer->addShape(shapeNuova);
         }
@@ -70,10 +70,10 @@ private:
     bool processWindow();
     void drawNoInput();
     void drawNoInput(const std::vector<Vector2f>& vertices,
-                     const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices);
+                     const PolygonSet& indices);
 
     void drawNoInput(const std::vector<std::shared_ptr<std::vector<Vector2f>>>& vertices,
-                     const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices);
+                     const PolygonSet& indices);
 
     void drawNoInput(const std::vector<Vector2f>& vertices,
                      const IndicesElement& indicesElement);
@@ -82,7 +82,7 @@ private:
                      const std::vector<IndicesElement>& indicesElement);
 
     void drawIndices(const std::vector<Vector2f>& vertices,
-                     const std::vector<std::shared_ptr<std::vector<unsigned int>>>& indices);
+                     const PolygonSet& indices);
 
     void askModeApp();
     void askLoadFromFile();
@@ -0,0 +1,132 @@
+#include "EdgeTree.h"
+#include <algorithm>
+
+EdgeTree::EdgeTree() {}
+
+EdgeTree::EdgeTree(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
+    build(vertices, indices);
+}
+
+void EdgeTree::build(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
+    Intersector::CreateEdgeArrays(vertices, indices, edges);
+    const unsigned int numberEdges = getNumberEdges();
+
+    order.resize(numberEdges);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        order[i] = i;
+    }
+    nodes.clear();
+    if (numberEdges == 0){
+        return;
+    }
+    nodes.reserve(2 * (numberEdges / EdgeTree::LEAF_SIZE + 1));
+
+    // the edges of a node are split in two halves on the longer side of the box, by the center of the edges
+    // nodes are made one after the other with a stack so a long polygon can not overflow the call stack
+    struct Range{
+        unsigned int node;
+        unsigned int first;
+        unsigned int count;
+    };
+    std::vector<Range> stack;
+    nodes.push_back({0.0f, 0.0f, 0.0f, 0.0f, 0, 0});
+    stack.push_back({0, 0, numberEdges});
+    while (!stack.empty()){
+        const Range range = stack.back();
+        stack.pop_back();
+
+        TreeNode box{edges.x1[order[range.first]], edges.y1[order[range.first]],
+                     edges.x1[order[range.first]], edges.y1[order[range.first]], range.first, range.count};
+        for (unsigned int i = range.first; i < range.first + range.count; i++){
+            const unsigned int e = order[i];
+            box.xMin = std::min(box.xMin, std::min(edges.x1[e], edges.x2[e]));
+            box.yMin = std::min(box.yMin, std::min(edges.y1[e], edges.y2[e]));
+            box.xMax = std::max(box.xMax, std::max(edges.x1[e], edges.x2[e]));
+            box.yMax = std::max(box.yMax, std::max(edges.y1[e], edges.y2[e]));
+        }
+
+        if (range.count > EdgeTree::LEAF_SIZE){
+            const bool alongX = box.xMax - box.xMin >= box.yMax - box.yMin;
+            const unsigned int half = range.count / 2;
+            std::nth_element(order.begin() + range.first, order.begin() + range.first + half, order.begin() + range.first + range.count,
+                             [this, alongX](unsigned int a, unsigned int b){
+                                 if (alongX){
+                                     return edges.x1[a] + edges.x2[a] < edges.x1[b] + edges.x2[b];
+                                 }
+                                 return edges.y1[a] + edges.y2[a] < edges.y1[b] + edges.y2[b];
+                             });
+            box.first = nodes.size();
+            box.count = 0;
+            nodes.push_back({0.0f, 0.0f, 0.0f, 0.0f, 0, 0});
+            nodes.push_back({0.0f, 0.0f, 0.0f, 0.0f, 0, 0});
+            stack.push_back({box.first, range.first, half});
+            stack.push_back({box.first + 1, range.first + half, range.count - half});
+        }
+        nodes[range.node] = box;
+    }
+}
+
+const EdgeArrays& EdgeTree::getEdges() const{
+    return edges;
+}
+
+unsigned int EdgeTree::getNumberEdges() const{
+    return edges.x1.size();
+}
+
+void EdgeTree::findLineEdges(const Vector2r& p1, const Vector2r& p2, std::vector<unsigned int>& found) const{
+    std::vector<unsigned int> stack;
+    findLineEdges(p1, p2, found, stack);
+}
+
+void EdgeTree::findLineEdges(const Vector2r& p1, const Vector2r& p2, std::vector<unsigned int>& found, std::vector<unsigned int>& stack) const{
+    found.clear();
+    if (nodes.empty()){
+        return;
+    }
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty()){
+        const TreeNode& node = nodes[stack.back()];
+        stack.pop_back();
+        if (IsLineAwayFromBox(p1, p2, node.xMin, node.yMin, node.xMax, node.yMax)){
+            continue;
+        }
+        if (node.count > 0){
+            found.insert(found.end(), order.begin() + node.first, order.begin() + node.first + node.count);
+        } else{
+            stack.push_back(node.first);
+            stack.push_back(node.first + 1);
+        }
+    }
+    // the network is created edge after edge, so they are returned in the order of the polygon
+    std::sort(found.begin(), found.end());
+}
+
+bool EdgeTree::IsLineAwayFromBox(const Vector2r& p1, const Vector2r& p2, double boxXMin, double boxYMin, double boxXMax, double boxYMax){
+    // if the corners of the box are on the same side of the line and far enough from it every edge inside is too
+    // for an edge on one side, (intersection - s1) dot (intersection - s2) is at least the product of the distances
+    // of s1 and s2 from the line, calculateIntersection returns OutsideSegment if it is greater than the tolerance,
+    // twice the tolerance is used so that rounding in calculateIntersection cannot change the result
+    const double lineX = (double)p2.x - p1.x;
+    const double lineY = (double)p2.y - p1.y;
+    const double minimumCross = 2.0 * Intersector::TOLERANCE_ON_VERTEX * (lineX * lineX + lineY * lineY);
+    const double cornersX[4] = {boxXMin, boxXMax, boxXMax, boxXMin};
+    const double cornersY[4] = {boxYMin, boxYMin, boxYMax, boxYMax};
+    bool positive = false;
+    bool negative = false;
+    for (unsigned int i = 0; i < 4; i++){
+        double cross = lineX * (cornersY[i] - p1.y) - lineY * (cornersX[i] - p1.x);
+        if (cross * cross <= minimumCross){
+            return false;
+        }
+        if (cross > 0.0){
+            positive = true;
+        } else{
+            negative = true;
+        }
+    }
+    return positive != negative;
+}
+
+const unsigned int EdgeTree::LEAF_SIZE = 8;
@@ -0,0 +1,60 @@
+#ifndef EDGETREE_H
+#define EDGETREE_H
+
+#include <vector>
+#include "Vector2.h"
+#include "Intersector.h"
+
+
+// bounding volume hierarchy over the edges of a polygon, every node has the bounding box of its edges
+// it is built once for a polygon and then used for every segment line: the nodes whose box is far
+// from the line are skipped with all their edges, so a line finds the k edges near it in about O(log n + k)
+class EdgeTree{
+
+public:
+    EdgeTree();
+    EdgeTree(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
+
+    EdgeTree(const EdgeTree&)                 = delete;
+    EdgeTree(EdgeTree&&) noexcept             = delete;
+    EdgeTree& operator=(const EdgeTree&)      = delete;
+    EdgeTree& operator=(EdgeTree&&) noexcept  = delete;
+
+    // edge i goes from the vertex of index i to the next one, as in Intersector::CreateEdgeArrays
+    void build(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
+
+    const EdgeArrays& getEdges() const;
+    unsigned int getNumberEdges() const;
+
+    // edges, in increasing order, that the line through p1 and p2 can intersect, every other edge
+    // is OutsideSegment for Intersector::calculateLineSegmentIntersection
+    void findLineEdges(const Vector2r& p1, const Vector2r& p2, std::vector<unsigned int>& found) const;
+    // the same, stack holds the nodes still to visit, a caller that keeps it does not allocate it for every line
+    void findLineEdges(const Vector2r& p1, const Vector2r& p2, std::vector<unsigned int>& found, std::vector<unsigned int>& stack) const;
+
+    // return: true if the line through p1 and p2 is so far from the box that it can not intersect any edge inside it
+    static bool IsLineAwayFromBox(const Vector2r& p1, const Vector2r& p2, double boxXMin, double boxYMin, double boxXMax, double boxYMax);
+
+    // maximum number of edges in a leaf
+    static const unsigned int LEAF_SIZE;
+
+private:
+    struct TreeNode{
+        Real xMin;
+        Real yMin;
+        Real xMax;
+        Real yMax;
+        // a leaf has the edges order[first] up to order[first + count], the others have count 0
+        // and the two children are first and first + 1
+        unsigned int first;
+        unsigned int count;
+    };
+
+    EdgeArrays edges;
+    // edges sorted so that the edges of every node are one after the other
+    std::vector<unsigned int> order;
+    // the root is the first node
+    std::vector<TreeNode> nodes;
+};
+
+#endif // EDGETREE_H
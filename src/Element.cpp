@@ -1,7 +1,9 @@
 #include "Element.h"
+#include "Predicates.h"
 #include "Logger.h"
 #include <exception>
 #include <math.h>
+#include <algorithm>
 
 #define FORWARD     true
 #define BACKWARD    false
@@ -14,13 +16,36 @@ Element::Element(const Polygon& _poly) :
     points(_poly.getPoints()), vertices(_poly.getPoints()), indices(_poly.getIndices()),
     numberStartIndices{_poly.getNumberIndices()}, numberAddedVertices{0}, created{false} {}
 
-Element::Element(const std::vector<Vector2f>& _points, const std::vector<unsigned int>& _indices) :
+Element::Element(const std::vector<Vector2r>& _points, const std::vector<Index>& _indices) :
     points(_points), vertices(_points), indices(_indices),
     numberStartIndices{(unsigned int)_indices.size()}, numberAddedVertices{0}, created{false} {}
 
-const std::vector<std::shared_ptr<std::vector<unsigned int>>>& Element::createElement(){
+Element::Element(const std::vector<Vector2r>& _points, const PolygonSet& _polygonsIndices) :
+    points(_points), vertices(_points), polygonsIndices(_polygonsIndices), numberAddedVertices{0}, created{true},
+    topRight{nullptr}, topLeft{nullptr}, bottomRight{nullptr}, bottomLeft{nullptr} {
+
+    if (!polygonsIndices.empty()){
+        indices = polygonsIndices[0].toVector();
+    } else{
+        LOG(LogLevel::ERROR) << "Element created without polygons indices";
+    }
+    numberStartIndices = indices.size();
+
+    Polygon::createBoundingBoxVariables(points, width, height, xMin, yMin);
+    left    = xMin;
+    bottom  = yMin;
+    right   = xMin + width;
+    top     = yMin + height;
+}
+
+const PolygonSet& Element::createElement(){
 //    LOG(LogLevel::DEBUG) << "started creating element";
     created = true;
+    // the corners of the bounding box are linked counterclockwise, a clockwise polygon is walked the other way
+    if (!isCounterclockwise()){
+        LOG(LogLevel::WARN) << "polygon of the element is clockwise, indices are reversed";
+        std::reverse(indices.begin(), indices.end());
+    }
     createBoundingBox();
     addExtraPoints();
 
@@ -41,7 +66,7 @@ const std::vector<std::shared_ptr<std::vector<unsigned int>>>& Element::createEl
     unsigned int numberPolygonsIndices = polygonsIndices.size();
     LOG(LogLevel::INFO) << "number of polygons: " << numberPolygonsIndices;
     for (unsigned int i = 0; i < numberPolygonsIndices; i++){
-        std::vector<unsigned int>& ind = *polygonsIndices[i];
+        const PolygonView ind = polygonsIndices[i];
         LOG l = LOG(LogLevel::INFO);
         l << "poly " << i << ") ";
         for (unsigned int j = 0; j < ind.size(); j++){
@@ -52,42 +77,68 @@ const std::vector<std::shared_ptr<std::vector<unsigned int>>>& Element::createEl
     return polygonsIndices;
 }
 
-const std::vector<Vector2f>& Element::getPoints() const{
+const std::vector<Vector2r>& Element::getPoints() const{
     if (!created){
 //        LOG(LogLevel::WARN) << "Element not created when trying to get points";
     }
     return points;
 }
 
-const std::vector<std::shared_ptr<std::vector<unsigned int>>>& Element::getPolygonsIndices() const{
+const PolygonSet& Element::getPolygonsIndices() const{
     if (!created){
         throw std::runtime_error("Element not created when trying to get indices");
     }
     return polygonsIndices;
 }
 
-const std::vector<unsigned int> Element::getStartingIndices() const{
+const std::vector<Index> Element::getStartingIndices() const{
     return indices;
 }
 
-float Element::getWidth() const{
+Real Element::getWidth() const{
     return width;
 }
 
-float Element::getHeight() const{
+Real Element::getHeight() const{
     return height;
 }
 
-float Element::getXMin() const{
+Real Element::getXMin() const{
     return xMin;
 }
 
-float Element::getYMin() const{
+Real Element::getYMin() const{
     return yMin;
 }
 
 const double Element::TOLERANCE = 1.0E-4;
 
+bool Element::isCounterclockwise() const{
+    if (numberStartIndices < 3){
+        return true;
+    }
+    // the lowest vertex (the leftmost between the lowest) is convex, so the turn there is the orientation of the polygon
+    unsigned int lowest = 0;
+    for (unsigned int i = 1; i < numberStartIndices; i++){
+        const Vector2r& vertex = points[indices[i]];
+        const Vector2r& vertexLowest = points[indices[lowest]];
+        if (vertex.y < vertexLowest.y || (vertex.y == vertexLowest.y && vertex.x < vertexLowest.x)){
+            lowest = i;
+        }
+    }
+    const Vector2r& vertex = points[indices[lowest]];
+    // neighbours equal to the lowest vertex do not give any turn, they are skipped
+    unsigned int previous = (lowest + numberStartIndices - 1) % numberStartIndices;
+    while (previous != lowest && points[indices[previous]] == vertex){
+        previous = (previous + numberStartIndices - 1) % numberStartIndices;
+    }
+    unsigned int next = (lowest + 1) % numberStartIndices;
+    while (next != lowest && points[indices[next]] == vertex){
+        next = (next + 1) % numberStartIndices;
+    }
+    return Predicates::Orient2d(points[indices[previous]], vertex, points[indices[next]]) >= 0;
+}
+
 void Element::createBoundingBox(){
     std::vector<unsigned int> indicesRight  = {0};
     std::vector<unsigned int> indicesLeft   = {0};
@@ -95,11 +146,11 @@ void Element::createBoundingBox(){
     std::vector<unsigned int> indicesBottom = {0};
     for (unsigned int i = 0; i < numberStartIndices; i++){
         if (indices[i] == 0){
-            i++;
+            continue;
         }
         unsigned int index = indices[i];
-        const float& x = vertices[index].x;
-        const float& y = vertices[index].y;
+        const Real& x = vertices[index].x;
+        const Real& y = vertices[index].y;
 
         if (x > vertices[indicesRight[0]].x + Element::TOLERANCE){
             indicesRight.clear();
@@ -150,41 +201,41 @@ void Element::createBoundingBox(){
     if (indexLeftBottom < 0){
 //        LDEB << "created left bottom";
         points.push_back({left, bottom});
-        bottomLeft  = new Node(numberStartIndices + numberAddedVertices);
+        bottomLeft  = nodePool.create(numberStartIndices + numberAddedVertices);
         bottomLeft->touched = true;
         numberAddedVertices++;
     } else{
-        bottomLeft  = new Node(indexLeftBottom);
+        bottomLeft  = nodePool.create(indexLeftBottom);
     }
     int indexRightBottom = getOneEqual(indicesRight, indicesBottom);
     if (indexRightBottom < 0){
 //        LDEB << "created right bottom";
         points.push_back({right, bottom});
-        bottomRight = new Node(numberStartIndices + numberAddedVertices);
+        bottomRight = nodePool.create(numberStartIndices + numberAddedVertices);
         bottomRight->touched = true;
         numberAddedVertices++;
     } else{
-        bottomRight = new Node(indexRightBottom);
+        bottomRight = nodePool.create(indexRightBottom);
     }
     int indexRightTop = getOneEqual(indicesRight, indicesTop);
     if (indexRightTop < 0){
 //        LDEB << "created right top";
         points.push_back({right, top});
-        topRight    = new Node(numberStartIndices + numberAddedVertices);
+        topRight    = nodePool.create(numberStartIndices + numberAddedVertices);
         topRight->touched = true;
         numberAddedVertices++;
     } else{
-        topRight    = new Node(indexRightTop);
+        topRight    = nodePool.create(indexRightTop);
     }
     int indexLeftTop = getOneEqual(indicesLeft, indicesTop);
     if (indexLeftTop < 0){
 //        LDEB << "created left top";
         points.push_back({left, top});
-        topLeft     = new Node(numberStartIndices + numberAddedVertices);
+        topLeft     = nodePool.create(numberStartIndices + numberAddedVertices);
         topLeft->touched = true;
         numberAddedVertices++;
     } else{
-        topLeft     = new Node(indexLeftTop);
+        topLeft     = nodePool.create(indexLeftTop);
     }
 
     topRight->next = topLeft;
@@ -214,7 +265,7 @@ void Element::addExtraPoints(){
         } else if (index == topLeft->getIndex()){
             tmp = topLeft;
         } else{
-            tmp = new Node(index);
+            tmp = nodePool.create(index);
             isNotBorder = true;
         }
         if (node != nullptr){
@@ -227,7 +278,7 @@ void Element::addExtraPoints(){
         if (!isNotBorder){
             continue;
         }
-        const Vector2f vec = points[index];
+        const Vector2r vec = points[index];
         if (abs(vec.x - right) < Element::TOLERANCE){
             add(topRight, node, BACKWARD, SMALLER, Y_CONSIDER);
         } else if (abs(vec.x - left) < Element::TOLERANCE){
@@ -255,7 +306,7 @@ void Element::addExtraPoints(){
             continue;
         }
 
-        const Vector2f vec = points[index];
+        const Vector2r vec = points[index];
         if (abs(vec.x - right) < Element::TOLERANCE){
             tryAdding({vec.x - width, vec.y}, bottomLeft, BACKWARD, BIGGER, Y_CONSIDER);
         } else if (abs(vec.x - left) < Element::TOLERANCE){
@@ -276,10 +327,10 @@ void Element::addExtraPoints(){
     LOG::NewLine(LogLevel::INFO);
 }
 
-void Element::tryAdding(const Vector2f& vector, Node* start, bool forward, bool bigger, bool x){
+void Element::tryAdding(const Vector2r& vector, Node* start, bool forward, bool bigger, bool x){
     Node* node;
-    float px = vector.x;
-    float py = vector.y;
+    Real px = vector.x;
+    Real py = vector.y;
     if (forward){
         node = start->next;
     } else{
@@ -330,7 +381,7 @@ void Element::tryAdding(const Vector2f& vector, Node* start, bool forward, bool
     }
 
     points.push_back(vector);
-    Node* create = new Node(numberStartIndices + numberAddedVertices);
+    Node* create = nodePool.create(numberStartIndices + numberAddedVertices);
     numberAddedVertices++;
     if (forward){
         Node* previous = node->previous;
@@ -367,7 +418,7 @@ void Element::add(Node* start, Node* create, bool forward, bool bigger, bool x){
         node = start->previous;
     }
     if (x){
-        float px = points[index].x;
+        Real px = points[index].x;
         if (bigger){
             while(px > points[node->getIndex()].x){
                 if (forward){
@@ -386,7 +437,7 @@ void Element::add(Node* start, Node* create, bool forward, bool bigger, bool x){
             }
         }
     } else{
-        float py = points[index].y;
+        Real py = points[index].y;
         if (bigger){
             while(py > points[node->getIndex()].y){
                 if (forward){
@@ -421,58 +472,63 @@ void Element::add(Node* start, Node* create, bool forward, bool bigger, bool x){
 }
 
 void Element::createMainPolygonUpdated(Node* start){
-    std::shared_ptr<std::vector<unsigned int>> mainIndices = std::make_shared<std::vector<unsigned int>>();
-    polygonsIndices.push_back(mainIndices);
+    polygonsIndices.startPolygon();
 
     Node* node = start;
     do{
-        mainIndices->push_back(node->getIndex());
+        polygonsIndices.addIndex(node->getIndex());
         node = node->up;
     } while (node != start);
 }
 
 void Element::createBorderPolygon(Node* start, Node* begin){
-    if (start->touched){
-        LOG(LogLevel::ERROR) << start->getIndex() << " starting node is not part of the main polygon";
-        return;
-    }
     LOG(LogLevel::INFO) << "begin node: " << begin->getIndex();
-    LOG(LogLevel::INFO) << "start node: " << start->getIndex();
-
-    while (start->next == start->up){
-        LOG(LogLevel::INFO) << "at " << start->getIndex();
-        start = start->next;
-        if (start == begin){
-            LOG(LogLevel::INFO) << "arrived at begin";
+    // every border polygon ends where the next one starts, so they are created one after the other until begin
+    while (true){
+        if (start->touched){
+            LOG(LogLevel::ERROR) << start->getIndex() << " starting node is not part of the main polygon";
             return;
         }
-    }
+        LOG(LogLevel::INFO) << "start node: " << start->getIndex();
+
+        while (start->next == start->up){
+            LOG(LogLevel::INFO) << "at " << start->getIndex();
+            start = start->next;
+            if (start == begin){
+                LOG(LogLevel::INFO) << "arrived at begin";
+                return;
+            }
+        }
 
-    LOG(LogLevel::INFO) << "real starting node: " << start->getIndex();
+        LOG(LogLevel::INFO) << "real starting node: " << start->getIndex();
 
-    std::shared_ptr<std::vector<unsigned int>> borderPoly = std::make_shared<std::vector<unsigned int>>();
-    polygonsIndices.push_back(borderPoly);
-    borderPoly->push_back(start->getIndex());
+        // the border polygon is the last one of polygonsIndices
+        PolygonSet& borderPoly = polygonsIndices;
+        borderPoly.startPolygon();
+        borderPoly.addIndex(start->getIndex());
 
-    Node* node = start->next;
-    LOG(LogLevel::INFO) << "adding border nodes: " << node->getIndex();
-    while (node->touched){
-        borderPoly->push_back(node->getIndex());
-        node = node->next;
+        Node* node = start->next;
         LOG(LogLevel::INFO) << "adding border nodes: " << node->getIndex();
-    }
-    borderPoly->push_back(node->getIndex());
-
-    if (node != begin){
-        createBorderPolygon(node, begin);
-    }
+        while (node->touched){
+            borderPoly.addIndex(node->getIndex());
+            node = node->next;
+            LOG(LogLevel::INFO) << "adding border nodes: " << node->getIndex();
+        }
+        borderPoly.addIndex(node->getIndex());
+        Node* const end = node;
 
-    node = node->down;
-    LOG(LogLevel::INFO) << "adding nodes inside polygon: " << node->getIndex();
-    while (node != start){
-        borderPoly->push_back(node->getIndex());
         node = node->down;
         LOG(LogLevel::INFO) << "adding nodes inside polygon: " << node->getIndex();
+        while (node != start){
+            borderPoly.addIndex(node->getIndex());
+            node = node->down;
+            LOG(LogLevel::INFO) << "adding nodes inside polygon: " << node->getIndex();
+        }
+
+        if (end == begin){
+            return;
+        }
+        start = end;
     }
 }
 
@@ -9,50 +9,55 @@ class Element{
 
 public:
     Element(const Polygon& _poly);
-    Element(const std::vector<Vector2f>& _points, const std::vector<unsigned int>& _indices);
+    Element(const std::vector<Vector2r>& _points, const std::vector<Index>& _indices);
+    // element already created (for example loaded from file), the first polygon has to be the main polygon
+    Element(const std::vector<Vector2r>& _points, const PolygonSet& _polygonsIndices);
 
     Element(const Element&)                 = delete;
     Element(Element&&) noexcept             = delete;
     Element& operator=(const Element&)      = delete;
     Element& operator=(Element&&) noexcept  = delete;
 
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& createElement();
+    const PolygonSet& createElement();
 
-    const std::vector<Vector2f>& getPoints() const;
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& getPolygonsIndices() const;
+    const std::vector<Vector2r>& getPoints() const;
+    const PolygonSet& getPolygonsIndices() const;
 
-    const std::vector<unsigned int> getStartingIndices() const;
+    const std::vector<Index> getStartingIndices() const;
 
-    float getWidth() const;
-    float getHeight() const;
+    Real getWidth() const;
+    Real getHeight() const;
 
-    float getXMin() const;
-    float getYMin() const;
+    Real getXMin() const;
+    Real getYMin() const;
 
     static const double TOLERANCE;
 
 private:
     // l'array a cui si aggiungono poi i punti successivi
-    std::vector<Vector2f> points;
+    std::vector<Vector2r> points;
     // l'array dei punti di partenza
-    std::vector<Vector2f> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<std::shared_ptr<std::vector<unsigned int>>> polygonsIndices;
+    std::vector<Vector2r> vertices;
+    std::vector<Index> indices;
+    PolygonSet polygonsIndices;
 
     unsigned int numberStartIndices;
     unsigned int numberAddedVertices;
 
     bool created;
 
-    float top;
-    float bottom;
-    float right;
-    float left;
+    Real top;
+    Real bottom;
+    Real right;
+    Real left;
 
-    float width;
-    float height;
-    float xMin;
-    float yMin;
+    Real width;
+    Real height;
+    Real xMin;
+    Real yMin;
+
+    // every node of the element is created here and released with the element
+    NodePool nodePool;
 
     Node* topRight;
     Node* topLeft;
@@ -61,19 +66,22 @@ private:
 
     // NOTE: node->touched in this context means that the node is on the border and not in the polygon
 
+    // return: true if the main polygon turns counterclockwise, the element is built on this orientation
+    bool isCounterclockwise() const;
+
     void createBoundingBox();
     void addExtraPoints();
 
     // used for trying to add opposite points (and nodes)
     // these are added just if there is not already a point
     // when adding, it also check whether to add them to border indices or polygon indices
-    void tryAdding(const Vector2f& vector, Node* start, bool forward, bool bigger, bool x);
+    void tryAdding(const Vector2r& vector, Node* start, bool forward, bool bigger, bool x);
     // used for adding normal nodes
     void add(Node* start, Node* create, bool forward, bool bigger, bool x);
 
     // create indices of main polygon with extra points added
     void createMainPolygonUpdated(Node* start);
-    // create all other border polygons
+    // create all other border polygons, one after the other from start until begin
     void createBorderPolygon(Node* start, Node* begin);
 
     // find the first node in order to start createBorderPolygon
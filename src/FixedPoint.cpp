@@ -0,0 +1,72 @@
+#include "FixedPoint.h"
+#include <math.h>
+
+Real FixedPoint::Quantize(Real coordinate){
+    double steps = round(coordinate * FixedPoint::STEPS_IN_ONE);
+    if (!(steps > -FixedPoint::MAX_STEPS)){
+        steps = -FixedPoint::MAX_STEPS + 1;
+    } else if (steps >= FixedPoint::MAX_STEPS){
+        steps = FixedPoint::MAX_STEPS - 1;
+    }
+    return FromSteps((int64_t)steps);
+}
+
+Vector2r FixedPoint::Quantize(const Vector2r& point){
+    return {Quantize(point.x), Quantize(point.y)};
+}
+
+bool FixedPoint::Quantize(std::vector<Vector2r>& points){
+    bool inside = true;
+    for (Vector2r& point : points){
+        const Vector2r quantized = Quantize(point);
+        if (!IsOnGrid(round(point.x * FixedPoint::STEPS_IN_ONE) * FixedPoint::STEP) ||
+            !IsOnGrid(round(point.y * FixedPoint::STEPS_IN_ONE) * FixedPoint::STEP)){
+            inside = false;
+        }
+        point = quantized;
+    }
+    return inside;
+}
+
+Vector2r FixedPoint::SnapCrossing(const Vector2r& first, const Vector2r& second, const Vector2r& s1, const Vector2r& s2){
+    // everything is in steps and relative to s1 and first, so the same crossing moved by whole steps is the same
+    const int64_t firstX = ToSteps(first.x);
+    const int64_t firstY = ToSteps(first.y);
+    const int64_t secondX = ToSteps(second.x);
+    const int64_t secondY = ToSteps(second.y);
+    const int64_t lineX = ToSteps(s2.x) - ToSteps(s1.x);
+    const int64_t lineY = ToSteps(s2.y) - ToSteps(s1.y);
+    // the distances from the line are exact, they have different signs so their difference is not 0
+    const int64_t distanceFirst = lineX * (firstY - ToSteps(s1.y)) - lineY * (firstX - ToSteps(s1.x));
+    const int64_t distanceSecond = lineX * (secondY - ToSteps(s1.y)) - lineY * (secondX - ToSteps(s1.x));
+    const double t = (double)distanceFirst / ((double)distanceFirst - (double)distanceSecond);
+    return {FromSteps(RoundAlong(firstX, secondX, t)), FromSteps(RoundAlong(firstY, secondY, t))};
+}
+
+Vector2r FixedPoint::SnapMeeting(const Vector2r& r1, const Vector2r& r2, const Vector2r& s1, const Vector2r& s2){
+    const int64_t r1X = ToSteps(r1.x);
+    const int64_t r1Y = ToSteps(r1.y);
+    const int64_t r2X = ToSteps(r2.x);
+    const int64_t r2Y = ToSteps(r2.y);
+    const int64_t sX = ToSteps(s2.x) - ToSteps(s1.x);
+    const int64_t sY = ToSteps(s2.y) - ToSteps(s1.y);
+    const int64_t rX = r2X - r1X;
+    const int64_t rY = r2Y - r1Y;
+    // t along the first line, both cross products are exact
+    const int64_t numerator = (ToSteps(s1.x) - r1X) * sY - (ToSteps(s1.y) - r1Y) * sX;
+    const int64_t denominator = rX * sY - rY * sX;
+    const double t = (double)numerator / (double)denominator;
+    return {FromSteps(RoundAlong(r1X, r2X, t)), FromSteps(RoundAlong(r1Y, r2Y, t))};
+}
+
+int64_t FixedPoint::RoundAlong(int64_t start, int64_t end, double t){
+    double steps = start + round(t * (double)(end - start));
+    // a meeting point far away from the lines is kept on the grid
+    if (!(steps > -FixedPoint::MAX_STEPS)){
+        return -FixedPoint::MAX_STEPS + 1;
+    }
+    if (steps >= FixedPoint::MAX_STEPS){
+        return FixedPoint::MAX_STEPS - 1;
+    }
+    return (int64_t)steps;
+}
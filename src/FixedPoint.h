@@ -0,0 +1,81 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+#include "Vector2.h"
+
+
+// coordinates on a fixed grid: a coordinate on the grid is a whole number of steps, it fits in an int32
+// and it is exact in Real, a step is a power of two so going from Real to steps and back loses nothing
+// with the grid (Mesh uses it when it is created with fixedPoint, and passes it down to the cut):
+// - the border and the element are moved to the nearest points of the grid, and the elements by whole steps
+// - the cross products of points on the grid are exact in int64 (Predicates uses them instead of its expansion)
+// - the crossing points of the cut are computed in steps from the differences of the points and rounded
+//   to the grid (snap rounding), so a piece of the element moved by whole steps is cutted in the same way
+// two points on the grid are the same only if they are equal, they are more than the tolerances apart otherwise
+class FixedPoint{
+
+public:
+    FixedPoint()                                = delete;
+    FixedPoint(const FixedPoint&)               = delete;
+    FixedPoint(FixedPoint&&) noexcept           = delete;
+    FixedPoint& operator=(const FixedPoint&)    = delete;
+    FixedPoint& operator=(FixedPoint&&) noexcept= delete;
+
+    // 2^-19, the squared step is more than Polygon::TOLERANCE_ARRANGEMENT
+    static constexpr double STEP = 1.0 / 524288.0;
+    static constexpr double STEPS_IN_ONE = 524288.0;
+    // a coordinate on the grid has less than 2^24 steps in float (so it is exact in float, up to 32)
+    // and less than 2^29 in double (up to 1024), the cross product of four of them fits in int64
+    static constexpr int64_t MAX_STEPS = std::is_same<Real, float>::value ? (int64_t)1 << 24 : (int64_t)1 << 29;
+
+    // return: true if the coordinate is a whole number of steps inside the grid
+    static constexpr bool IsOnGrid(Real coordinate){
+        const double steps = coordinate * STEPS_IN_ONE;
+        return steps > -MAX_STEPS && steps < MAX_STEPS && steps == (double)(int64_t)steps;
+    }
+
+    static constexpr bool AreOnGrid(Real ax, Real ay, Real bx, Real by, Real cx, Real cy, Real dx, Real dy){
+        return IsOnGrid(ax) && IsOnGrid(ay) && IsOnGrid(bx) && IsOnGrid(by) &&
+               IsOnGrid(cx) && IsOnGrid(cy) && IsOnGrid(dx) && IsOnGrid(dy);
+    }
+
+    // return: the steps of a coordinate already on the grid
+    static constexpr int64_t ToSteps(Real coordinate){
+        return (int64_t)(coordinate * STEPS_IN_ONE);
+    }
+
+    static constexpr Real FromSteps(int64_t steps){
+        return (Real)(steps * STEP);
+    }
+
+    // return: 1 if (b - a) x (d - c) is positive, -1 if it is negative, 0 if they are parallel
+    // as Predicates::Cross, exact for points on the grid
+    static constexpr int Cross(Real ax, Real ay, Real bx, Real by, Real cx, Real cy, Real dx, Real dy){
+        const int64_t determinant = (ToSteps(bx) - ToSteps(ax)) * (ToSteps(dy) - ToSteps(cy)) -
+                                    (ToSteps(by) - ToSteps(ay)) * (ToSteps(dx) - ToSteps(cx));
+        return (determinant > 0) - (determinant < 0);
+    }
+
+    // return: the nearest coordinate on the grid, the ones outside the grid go to its last step
+    static Real Quantize(Real coordinate);
+    static Vector2r Quantize(const Vector2r& point);
+    // return: false if some point was outside the grid
+    static bool Quantize(std::vector<Vector2r>& points);
+
+    // first, second, s1 and s2 are on the grid, first and second are on different sides of the line from s1 to s2
+    // return: the point of the grid nearest to where the line crosses the segment from first to second
+    static Vector2r SnapCrossing(const Vector2r& first, const Vector2r& second, const Vector2r& s1, const Vector2r& s2);
+
+    // r1, r2, s1 and s2 are on the grid and the two lines are not parallel
+    // return: the point of the grid nearest to where the line from r1 to r2 meets the line from s1 to s2
+    static Vector2r SnapMeeting(const Vector2r& r1, const Vector2r& r2, const Vector2r& s1, const Vector2r& s2);
+
+private:
+    // return: start moved by t times the steps from start to end, rounded to a whole step
+    static int64_t RoundAlong(int64_t start, int64_t end, double t);
+};
+
+#endif // FIXEDPOINT_H
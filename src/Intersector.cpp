@@ -1,19 +1,31 @@
 #include "Intersector.h"
 #include "math.h"
 #include "Logger.h"
+#include "Predicates.h"
 
-Intersector::Intersector() : toleranceParallelism{1.0E-4}, toleranceOnVertex{1.0E-4}, intersectionPoint{0.0, 0.0} {
+// the batch functions use the widest simd the compiler is allowed to use, there is no check at run time
+// the simd code reads four float coordinates in a register, in double precision the edges are intersected one by one
+#if !defined(POLYGON_DOUBLE_PRECISION) && defined(__AVX__)
+#include <immintrin.h>
+#define INTERSECTOR_AVX
+#elif !defined(POLYGON_DOUBLE_PRECISION) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define INTERSECTOR_SSE2
+#endif
+
+Intersector::Intersector() : toleranceParallelism{Intersector::TOLERANCE_PARALLELISM}, toleranceOnVertex{Intersector::TOLERANCE_ON_VERTEX},
+                             intersectionPoint{0.0, 0.0} {
     reset();
 }
 
-void Intersector::setSegment1(const Vector2f &_r1, const Vector2f &_r2){
+void Intersector::setSegment1(const Vector2r &_r1, const Vector2r &_r2){
     reset();
 
     r1 = _r1;
     r2 = _r2;
 }
 
-void Intersector::setSegment2(const Vector2f &_s1, const Vector2f &_s2){
+void Intersector::setSegment2(const Vector2r &_s1, const Vector2r &_s2){
     reset();
 
     s1 = _s1;
@@ -28,7 +40,7 @@ void Intersector::setToleranceParallelism(double tolerance){
     }
 }
 
-void Intersector::setToleranceOnVertex(float tolerance){
+void Intersector::setToleranceOnVertex(Real tolerance){
     if (tolerance > 0){
         toleranceOnVertex = tolerance;
     } else{
@@ -36,7 +48,7 @@ void Intersector::setToleranceOnVertex(float tolerance){
     }
 }
 
-Vector2f Intersector::getIntersectionPoint(){
+Vector2r Intersector::getIntersectionPoint(){
     if (!pointIntersectionCalculated){
         calculateLinesDeterminantIntersection();
     }
@@ -69,10 +81,10 @@ IntersectionType Intersector::calculateIntersection(bool isFirstLine, bool isSec
     calculateLinesDeterminantIntersection();
     if (abs(determinant) > toleranceParallelism){
         double toleranceVertexSquared = toleranceOnVertex * toleranceOnVertex;
-        Vector2f differencer1 = intersectionPoint - r1;
-        Vector2f differencer2 = intersectionPoint - r2;
-        Vector2f differences1 = intersectionPoint - s1;
-        Vector2f differences2 = intersectionPoint - s2;
+        Vector2r differencer1 = intersectionPoint - r1;
+        Vector2r differencer2 = intersectionPoint - r2;
+        Vector2r differences1 = intersectionPoint - s1;
+        Vector2r differences2 = intersectionPoint - s2;
 
         bool firstOnSegment = differencer1.normSquared() < toleranceVertexSquared || differencer2.normSquared() < toleranceVertexSquared;
         bool secondOnSegment = differences1.normSquared() < toleranceVertexSquared || differences2.normSquared() < toleranceVertexSquared;
@@ -125,8 +137,8 @@ LineSegmentIntersection Intersector::calculateLineSegmentIntersection(){
     if (abs(determinant) > toleranceParallelism){
         double toleranceVertexSquared = toleranceOnVertex * toleranceOnVertex;
 
-        Vector2f difference1 = intersectionPoint - s1;
-        Vector2f difference2 = intersectionPoint - s2;
+        Vector2r difference1 = intersectionPoint - s1;
+        Vector2r difference2 = intersectionPoint - s2;
 
         bool firstOnSegment  = difference1.normSquared() < toleranceVertexSquared;
         bool secondOnSegment = difference2.normSquared() < toleranceVertexSquared;
@@ -159,8 +171,8 @@ RelativePosition Intersector::calculateRelativePosition(){
 
 RelativePosition Intersector::calculateRelativePosition(double tolerance){
     relativePositionCalculated = true;
-    Vector2f v1 = r2 - r1;
-    Vector2f v2 = s2 - s1;
+    Vector2r v1 = r2 - r1;
+    Vector2r v2 = s2 - s1;
     double dotProduct = v1.x * v2.y - v1.y * v2.x;
     if (dotProduct > tolerance){
         relativePosition = RelativePosition::Positive;
@@ -172,6 +184,308 @@ RelativePosition Intersector::calculateRelativePosition(double tolerance){
     return relativePosition;
 }
 
+const double Intersector::TOLERANCE_PARALLELISM = 1.0E-4;
+const Real Intersector::TOLERANCE_ON_VERTEX = 1.0E-4;
+
+void Intersector::calculateLineSegmentIntersections(const EdgeArrays& edges,
+                                                    std::vector<LineSegmentIntersection>& types, std::vector<Vector2r>& points) const{
+    const unsigned int numberEdges = edges.x1.size();
+    types.resize(numberEdges);
+    points.resize(numberEdges);
+
+    unsigned int i = 0;
+
+#if defined(INTERSECTOR_AVX) || defined(INTERSECTOR_SSE2)
+    // every operation is done with the same precision and in the same order as calculateLinesDeterminantIntersection
+    // and calculateLineSegmentIntersection, differences of vertices are float and the determinant is double
+    const double lineA = r2.y - r1.y;
+    const double lineB = r1.x - r2.x;
+    const double lineC = lineA * r1.x + lineB * r1.y;
+    const float toleranceVertexSquared = toleranceOnVertex * toleranceOnVertex;
+
+    const __m128 toleranceVertex4 = _mm_set1_ps(toleranceOnVertex);
+    const __m128 toleranceVertexSquared4 = _mm_set1_ps(toleranceVertexSquared);
+
+#if defined(INTERSECTOR_AVX)
+    const __m256d a1 = _mm256_set1_pd(lineA);
+    const __m256d b1 = _mm256_set1_pd(lineB);
+    const __m256d c1 = _mm256_set1_pd(lineC);
+    const __m256d toleranceParallelism4 = _mm256_set1_pd(toleranceParallelism);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+#else
+    const __m128d a1 = _mm_set1_pd(lineA);
+    const __m128d b1 = _mm_set1_pd(lineB);
+    const __m128d c1 = _mm_set1_pd(lineC);
+    const __m128d toleranceParallelism2 = _mm_set1_pd(toleranceParallelism);
+    const __m128d signMask = _mm_set1_pd(-0.0);
+#endif
+
+    for (; i + 4 <= numberEdges; i += 4){
+        const __m128 s1x = _mm_loadu_ps(&edges.x1[i]);
+        const __m128 s1y = _mm_loadu_ps(&edges.y1[i]);
+        const __m128 s2x = _mm_loadu_ps(&edges.x2[i]);
+        const __m128 s2y = _mm_loadu_ps(&edges.y2[i]);
+
+        const __m128 a2f = _mm_sub_ps(s2y, s1y);
+        const __m128 b2f = _mm_sub_ps(s1x, s2x);
+
+        __m128 intersectionX;
+        __m128 intersectionY;
+        int notParallel;
+
+#if defined(INTERSECTOR_AVX)
+        const __m256d a2 = _mm256_cvtps_pd(a2f);
+        const __m256d b2 = _mm256_cvtps_pd(b2f);
+        const __m256d c2 = _mm256_add_pd(_mm256_mul_pd(a2, _mm256_cvtps_pd(s1x)), _mm256_mul_pd(b2, _mm256_cvtps_pd(s1y)));
+
+        const __m256d determinant = _mm256_sub_pd(_mm256_mul_pd(a1, b2), _mm256_mul_pd(a2, b1));
+        notParallel = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_andnot_pd(signMask, determinant), toleranceParallelism4, _CMP_GT_OQ));
+
+        intersectionX = _mm256_cvtpd_ps(_mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(b2, c1), _mm256_mul_pd(b1, c2)), determinant));
+        intersectionY = _mm256_cvtpd_ps(_mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(a1, c2), _mm256_mul_pd(a2, c1)), determinant));
+#else
+        // two edges in every register of doubles, low and high half of the float registers
+        const __m128d a2Low  = _mm_cvtps_pd(a2f);
+        const __m128d a2High = _mm_cvtps_pd(_mm_movehl_ps(a2f, a2f));
+        const __m128d b2Low  = _mm_cvtps_pd(b2f);
+        const __m128d b2High = _mm_cvtps_pd(_mm_movehl_ps(b2f, b2f));
+        const __m128d c2Low  = _mm_add_pd(_mm_mul_pd(a2Low, _mm_cvtps_pd(s1x)), _mm_mul_pd(b2Low, _mm_cvtps_pd(s1y)));
+        const __m128d c2High = _mm_add_pd(_mm_mul_pd(a2High, _mm_cvtps_pd(_mm_movehl_ps(s1x, s1x))),
+                                          _mm_mul_pd(b2High, _mm_cvtps_pd(_mm_movehl_ps(s1y, s1y))));
+
+        const __m128d determinantLow  = _mm_sub_pd(_mm_mul_pd(a1, b2Low), _mm_mul_pd(a2Low, b1));
+        const __m128d determinantHigh = _mm_sub_pd(_mm_mul_pd(a1, b2High), _mm_mul_pd(a2High, b1));
+        notParallel = _mm_movemask_pd(_mm_cmpgt_pd(_mm_andnot_pd(signMask, determinantLow), toleranceParallelism2)) |
+                      _mm_movemask_pd(_mm_cmpgt_pd(_mm_andnot_pd(signMask, determinantHigh), toleranceParallelism2)) << 2;
+
+        const __m128d xLow  = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(b2Low, c1), _mm_mul_pd(b1, c2Low)), determinantLow);
+        const __m128d xHigh = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(b2High, c1), _mm_mul_pd(b1, c2High)), determinantHigh);
+        const __m128d yLow  = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(a1, c2Low), _mm_mul_pd(a2Low, c1)), determinantLow);
+        const __m128d yHigh = _mm_div_pd(_mm_sub_pd(_mm_mul_pd(a1, c2High), _mm_mul_pd(a2High, c1)), determinantHigh);
+        intersectionX = _mm_movelh_ps(_mm_cvtpd_ps(xLow), _mm_cvtpd_ps(xHigh));
+        intersectionY = _mm_movelh_ps(_mm_cvtpd_ps(yLow), _mm_cvtpd_ps(yHigh));
+#endif
+
+        // from here everything is float as in calculateLineSegmentIntersection
+        const __m128 difference1x = _mm_sub_ps(intersectionX, s1x);
+        const __m128 difference1y = _mm_sub_ps(intersectionY, s1y);
+        const __m128 difference2x = _mm_sub_ps(intersectionX, s2x);
+        const __m128 difference2y = _mm_sub_ps(intersectionY, s2y);
+
+        const __m128 norm1 = _mm_add_ps(_mm_mul_ps(difference1x, difference1x), _mm_mul_ps(difference1y, difference1y));
+        const __m128 norm2 = _mm_add_ps(_mm_mul_ps(difference2x, difference2x), _mm_mul_ps(difference2y, difference2y));
+        const __m128 dot   = _mm_add_ps(_mm_mul_ps(difference1x, difference2x), _mm_mul_ps(difference1y, difference2y));
+
+        const int outside = _mm_movemask_ps(_mm_cmpgt_ps(dot, toleranceVertex4));
+        const int firstOnSegment = _mm_movemask_ps(_mm_cmplt_ps(norm1, toleranceVertexSquared4));
+        const int secondOnSegment = _mm_movemask_ps(_mm_cmplt_ps(norm2, toleranceVertexSquared4));
+
+        float x[4];
+        float y[4];
+        _mm_storeu_ps(x, intersectionX);
+        _mm_storeu_ps(y, intersectionY);
+
+        for (unsigned int l = 0; l < 4; l++){
+            const int bit = 1 << l;
+            if (!(notParallel & bit)){
+                types[i + l] = LineSegmentIntersection::Parallel;
+                points[i + l] = Vector2r(0.0f, 0.0f);
+                continue;
+            }
+            points[i + l] = Vector2r(x[l], y[l]);
+            if (outside & bit){
+                types[i + l] = LineSegmentIntersection::OutsideSegment;
+            } else if (firstOnSegment & bit){
+                types[i + l] = LineSegmentIntersection::FirstVertex;
+            } else if (secondOnSegment & bit){
+                types[i + l] = LineSegmentIntersection::SecondVertex;
+            } else{
+                types[i + l] = LineSegmentIntersection::InsideSegment;
+            }
+        }
+    }
+#endif
+
+    // edges left (or all of them without simd) are intersected one by one
+    Intersector inter(*this);
+    for (; i < numberEdges; i++){
+        inter.setSegment2(Vector2r(edges.x1[i], edges.y1[i]), Vector2r(edges.x2[i], edges.y2[i]));
+        types[i] = inter.calculateLineSegmentIntersection();
+        points[i] = inter.getIntersectionPoint();
+    }
+}
+
+void Intersector::CalculateRelativePositions(const EdgeArrays& edges, const Vector2r& point,
+                                             std::vector<RelativePosition>& positions, double tolerance){
+    const unsigned int numberEdges = edges.x1.size();
+    positions.resize(numberEdges);
+
+    unsigned int i = 0;
+
+#if defined(INTERSECTOR_AVX) || defined(INTERSECTOR_SSE2)
+    // the cross product is float as in calculateRelativePosition, it is compared with the tolerance as double
+    const __m128 pointX = _mm_set1_ps(point.x);
+    const __m128 pointY = _mm_set1_ps(point.y);
+#if defined(INTERSECTOR_AVX)
+    const __m256d positiveTolerance = _mm256_set1_pd(tolerance);
+    const __m256d negativeTolerance = _mm256_set1_pd(-tolerance);
+#else
+    const __m128d positiveTolerance = _mm_set1_pd(tolerance);
+    const __m128d negativeTolerance = _mm_set1_pd(-tolerance);
+#endif
+
+    for (; i + 4 <= numberEdges; i += 4){
+        const __m128 x1 = _mm_loadu_ps(&edges.x1[i]);
+        const __m128 y1 = _mm_loadu_ps(&edges.y1[i]);
+        const __m128 edgeX = _mm_sub_ps(_mm_loadu_ps(&edges.x2[i]), x1);
+        const __m128 edgeY = _mm_sub_ps(_mm_loadu_ps(&edges.y2[i]), y1);
+        const __m128 differenceX = _mm_sub_ps(pointX, x1);
+        const __m128 differenceY = _mm_sub_ps(pointY, y1);
+        const __m128 cross = _mm_sub_ps(_mm_mul_ps(edgeX, differenceY), _mm_mul_ps(edgeY, differenceX));
+
+#if defined(INTERSECTOR_AVX)
+        const __m256d crossDouble = _mm256_cvtps_pd(cross);
+        const int positive = _mm256_movemask_pd(_mm256_cmp_pd(crossDouble, positiveTolerance, _CMP_GT_OQ));
+        const int negative = _mm256_movemask_pd(_mm256_cmp_pd(crossDouble, negativeTolerance, _CMP_LT_OQ));
+#else
+        const __m128d crossLow  = _mm_cvtps_pd(cross);
+        const __m128d crossHigh = _mm_cvtps_pd(_mm_movehl_ps(cross, cross));
+        const int positive = _mm_movemask_pd(_mm_cmpgt_pd(crossLow, positiveTolerance)) |
+                             _mm_movemask_pd(_mm_cmpgt_pd(crossHigh, positiveTolerance)) << 2;
+        const int negative = _mm_movemask_pd(_mm_cmplt_pd(crossLow, negativeTolerance)) |
+                             _mm_movemask_pd(_mm_cmplt_pd(crossHigh, negativeTolerance)) << 2;
+#endif
+
+        for (unsigned int l = 0; l < 4; l++){
+            const int bit = 1 << l;
+            if (positive & bit){
+                positions[i + l] = RelativePosition::Positive;
+            } else if (negative & bit){
+                positions[i + l] = RelativePosition::Negative;
+            } else{
+                positions[i + l] = RelativePosition::Parallel;
+            }
+        }
+    }
+#endif
+
+    Intersector inter;
+    for (; i < numberEdges; i++){
+        const Vector2r first(edges.x1[i], edges.y1[i]);
+        inter.setSegment1(first, Vector2r(edges.x2[i], edges.y2[i]));
+        inter.setSegment2(first, point);
+        positions[i] = inter.calculateRelativePosition(tolerance);
+    }
+}
+
+void Intersector::CalculateSides(const Vector2r& s1, const Vector2r& s2, const std::vector<Real>& x, const std::vector<Real>& y,
+                                 std::vector<double>& distances, std::vector<int>& sides){
+    const unsigned int numberPoints = x.size();
+    distances.resize(numberPoints);
+    sides.resize(numberPoints);
+    const double lineX = (double)s2.x - s1.x;
+    const double lineY = (double)s2.y - s1.y;
+
+    unsigned int i = 0;
+
+#if defined(INTERSECTOR_AVX) || defined(INTERSECTOR_SSE2)
+    // the products are the same of Predicates::Cross, a sign is taken only if it is beyond the error bound
+#if defined(INTERSECTOR_AVX)
+    const __m256d lineX4 = _mm256_set1_pd(lineX);
+    const __m256d lineY4 = _mm256_set1_pd(lineY);
+    const __m256d s1x4 = _mm256_set1_pd(s1.x);
+    const __m256d s1y4 = _mm256_set1_pd(s1.y);
+    const __m256d errorBound4 = _mm256_set1_pd(Predicates::ERROR_BOUND_CROSS);
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+#else
+    const __m128d lineX2 = _mm_set1_pd(lineX);
+    const __m128d lineY2 = _mm_set1_pd(lineY);
+    const __m128d s1x2 = _mm_set1_pd(s1.x);
+    const __m128d s1y2 = _mm_set1_pd(s1.y);
+    const __m128d errorBound2 = _mm_set1_pd(Predicates::ERROR_BOUND_CROSS);
+    const __m128d signMask = _mm_set1_pd(-0.0);
+#endif
+
+    for (; i + 4 <= numberPoints; i += 4){
+        const __m128 pointX = _mm_loadu_ps(&x[i]);
+        const __m128 pointY = _mm_loadu_ps(&y[i]);
+        int positive;
+        int negative;
+
+#if defined(INTERSECTOR_AVX)
+        const __m256d left = _mm256_mul_pd(lineX4, _mm256_sub_pd(_mm256_cvtps_pd(pointY), s1y4));
+        const __m256d right = _mm256_mul_pd(lineY4, _mm256_sub_pd(_mm256_cvtps_pd(pointX), s1x4));
+        const __m256d determinant = _mm256_sub_pd(left, right);
+        const __m256d bound = _mm256_mul_pd(errorBound4, _mm256_add_pd(_mm256_andnot_pd(signMask, left), _mm256_andnot_pd(signMask, right)));
+        positive = _mm256_movemask_pd(_mm256_cmp_pd(determinant, bound, _CMP_GT_OQ));
+        negative = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_xor_pd(determinant, signMask), bound, _CMP_GT_OQ));
+        _mm256_storeu_pd(&distances[i], determinant);
+#else
+        const __m128d leftLow   = _mm_mul_pd(lineX2, _mm_sub_pd(_mm_cvtps_pd(pointY), s1y2));
+        const __m128d leftHigh  = _mm_mul_pd(lineX2, _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(pointY, pointY)), s1y2));
+        const __m128d rightLow  = _mm_mul_pd(lineY2, _mm_sub_pd(_mm_cvtps_pd(pointX), s1x2));
+        const __m128d rightHigh = _mm_mul_pd(lineY2, _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(pointX, pointX)), s1x2));
+        const __m128d determinantLow  = _mm_sub_pd(leftLow, rightLow);
+        const __m128d determinantHigh = _mm_sub_pd(leftHigh, rightHigh);
+        const __m128d boundLow  = _mm_mul_pd(errorBound2, _mm_add_pd(_mm_andnot_pd(signMask, leftLow), _mm_andnot_pd(signMask, rightLow)));
+        const __m128d boundHigh = _mm_mul_pd(errorBound2, _mm_add_pd(_mm_andnot_pd(signMask, leftHigh), _mm_andnot_pd(signMask, rightHigh)));
+        positive = _mm_movemask_pd(_mm_cmpgt_pd(determinantLow, boundLow)) |
+                   _mm_movemask_pd(_mm_cmpgt_pd(determinantHigh, boundHigh)) << 2;
+        negative = _mm_movemask_pd(_mm_cmpgt_pd(_mm_xor_pd(determinantLow, signMask), boundLow)) |
+                   _mm_movemask_pd(_mm_cmpgt_pd(_mm_xor_pd(determinantHigh, signMask), boundHigh)) << 2;
+        _mm_storeu_pd(&distances[i], determinantLow);
+        _mm_storeu_pd(&distances[i + 2], determinantHigh);
+#endif
+
+        for (unsigned int l = 0; l < 4; l++){
+            const int bit = 1 << l;
+            if (positive & bit){
+                sides[i + l] = 1;
+            } else if (negative & bit){
+                sides[i + l] = -1;
+            } else{
+                sides[i + l] = Predicates::Orient2d(s1, s2, Vector2r(x[i + l], y[i + l]));
+            }
+        }
+    }
+#endif
+
+    for (; i < numberPoints; i++){
+        distances[i] = lineX * ((double)y[i] - s1.y) - lineY * ((double)x[i] - s1.x);
+        sides[i] = Predicates::Orient2d(s1, s2, Vector2r(x[i], y[i]));
+    }
+}
+
+void Intersector::CreateEdgeArrays(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices, EdgeArrays& edges){
+    const unsigned int numberEdges = indices.size();
+    edges.x1.resize(numberEdges);
+    edges.y1.resize(numberEdges);
+    edges.x2.resize(numberEdges);
+    edges.y2.resize(numberEdges);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        const Vector2r& first = vertices[indices[i]];
+        const Vector2r& second = vertices[indices[(i + 1) % numberEdges]];
+        edges.x1[i] = first.x;
+        edges.y1[i] = first.y;
+        edges.x2[i] = second.x;
+        edges.y2[i] = second.y;
+    }
+}
+
+void Intersector::CreateEdgeArrays(const EdgeArrays& edges, const std::vector<unsigned int>& selected, EdgeArrays& selectedEdges){
+    const unsigned int numberSelected = selected.size();
+    selectedEdges.x1.resize(numberSelected);
+    selectedEdges.y1.resize(numberSelected);
+    selectedEdges.x2.resize(numberSelected);
+    selectedEdges.y2.resize(numberSelected);
+    for (unsigned int i = 0; i < numberSelected; i++){
+        selectedEdges.x1[i] = edges.x1[selected[i]];
+        selectedEdges.y1[i] = edges.y1[selected[i]];
+        selectedEdges.x2[i] = edges.x2[selected[i]];
+        selectedEdges.y2[i] = edges.y2[selected[i]];
+    }
+}
+
 void Intersector::reset(){
     intersectionPoint.x = 0.0f;
     intersectionPoint.y = 0.0f;
@@ -1,8 +1,10 @@
 #ifndef INTERSECTOR_H
 #define INTERSECTOR_H
 
-#include "Vector2f.h"
+#include "Vector2.h"
+#include "PolygonSet.h"
 #include <iostream>
+#include <vector>
 
 
 enum class IntersectionType{
@@ -34,18 +36,27 @@ std::ostream& operator<<(std::ostream& ostream, const LineSegmentIntersection& t
 
 std::ostream& operator<<(std::ostream& ostream, const RelativePosition& type);
 
+// edges stored as structure of arrays, edge i goes from (x1[i], y1[i]) to (x2[i], y2[i])
+// it is the input of the batch functions of Intersector, that read four edges at a time
+struct EdgeArrays{
+    std::vector<Real> x1;
+    std::vector<Real> y1;
+    std::vector<Real> x2;
+    std::vector<Real> y2;
+};
+
 class Intersector{
 
 public:
     Intersector();
 
-    void setSegment1(const Vector2f& _r1, const Vector2f& _r2);
-    void setSegment2(const Vector2f& _s1, const Vector2f& _s2);
+    void setSegment1(const Vector2r& _r1, const Vector2r& _r2);
+    void setSegment2(const Vector2r& _s1, const Vector2r& _s2);
 
     void setToleranceParallelism(double tolerance);
-    void setToleranceOnVertex(float tolerance);
+    void setToleranceOnVertex(Real tolerance);
 
-    Vector2f getIntersectionPoint();
+    Vector2r getIntersectionPoint();
     IntersectionType getIntersectionType();
     LineSegmentIntersection getLineSegmentIntersection();
     RelativePosition getRelativePosition();
@@ -55,6 +66,35 @@ public:
     RelativePosition calculateRelativePosition();
     RelativePosition calculateRelativePosition(double tolerance);
 
+    // intersect line 1 with every edge, the result of edge i is the same calculateLineSegmentIntersection and
+    // getIntersectionPoint would give after setSegment2 on edge i (for calculateIntersection(true, false)
+    // FirstVertex and SecondVertex are SecondOnVertex), the intersection point is 0 when parallel
+    // it uses AVX or SSE2 when the compiler has them, otherwise every edge is intersected one by one
+    void calculateLineSegmentIntersections(const EdgeArrays& edges,
+                                           std::vector<LineSegmentIntersection>& types, std::vector<Vector2r>& points) const;
+
+    // relative position of point with respect to every edge, the same as calculateRelativePosition
+    // with setSegment1 on edge i and setSegment2 from the first vertex of edge i to point
+    static void CalculateRelativePositions(const EdgeArrays& edges, const Vector2r& point,
+                                           std::vector<RelativePosition>& positions,
+                                           double tolerance = Intersector::TOLERANCE_PARALLELISM);
+
+    // side of every point (x[i], y[i]) with respect to the line from s1 to s2, distances[i] is (s2 - s1) x (point - s1)
+    // in double and sides[i] is its sign as Predicates::Orient2d(s1, s2, point) gives it, so it is exact
+    // the error bound of Predicates is checked on four points at a time with AVX or SSE2,
+    // only the points it can not decide (on the line or very near it) are computed again one by one
+    static void CalculateSides(const Vector2r& s1, const Vector2r& s2, const std::vector<Real>& x, const std::vector<Real>& y,
+                               std::vector<double>& distances, std::vector<int>& sides);
+
+    // edge i goes from vertex indices[i] to vertex indices[i + 1], the last one closes the polygon
+    static void CreateEdgeArrays(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices, EdgeArrays& edges);
+    // just the edges in selected, edge i of selectedEdges is edge selected[i] of edges
+    static void CreateEdgeArrays(const EdgeArrays& edges, const std::vector<unsigned int>& selected, EdgeArrays& selectedEdges);
+
+    // default tolerances
+    static const double TOLERANCE_PARALLELISM;
+    static const Real TOLERANCE_ON_VERTEX;
+
 private:
     bool pointIntersectionCalculated;
     bool intersectionCalculated;
@@ -62,20 +102,20 @@ private:
     bool relativePositionCalculated;
 
     double toleranceParallelism;
-    float toleranceOnVertex;
+    Real toleranceOnVertex;
 
     IntersectionType intersectionType;
     LineSegmentIntersection lineSegmentIntersection;
     RelativePosition relativePosition;
-    Vector2f intersectionPoint;
+    Vector2r intersectionPoint;
 
     double determinant;
     double a1, b1, c1;
     double a2, b2, c2;
-    Vector2f r1;
-    Vector2f r2;
-    Vector2f s1;
-    Vector2f s2;
+    Vector2r r1;
+    Vector2r r2;
+    Vector2r s1;
+    Vector2r s2;
 
     void reset();
 
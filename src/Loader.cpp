@@ -1,7 +1,9 @@
 #include "Loader.h"
 #include "Logger.h"
+#include "PolygonValidator.h"
 #include <fstream>
 #include <sstream>
+#include <limits>
 
 int Loader::SearchInFile(const std::string& fileName, const std::string& search, bool drawError){
     std::ifstream file;
@@ -27,10 +29,15 @@ int Loader::GetNumberVerticesFromFile(const std::string& fileName){
         LOG(LogLevel::ERROR) << "number of vertices should be a number greather than 0";
         return -2;
     }
+    if ((uint64_t)numberVertices > PolygonSet::MAX_NUMBER_POINTS){
+        LOG(LogLevel::ERROR) << "number of vertices should be at most " << PolygonSet::MAX_NUMBER_POINTS
+                             << " (the width of the indices)";
+        return -2;
+    }
     return numberVertices;
 }
 
-int Loader::LoadSegmentFromFile(std::vector<Vector2f>& segmentPoints, const std::string& fileName){
+int Loader::LoadSegmentFromFile(std::vector<Vector2r>& segmentPoints, const std::string& fileName){
     std::ifstream file;
     int found = OpenFileAndSearch(file, fileName, "segment");
     if (found != 1){
@@ -40,7 +47,7 @@ int Loader::LoadSegmentFromFile(std::vector<Vector2f>& segmentPoints, const std:
     std::stringstream convert;
     for (unsigned int i = 0; i < 2; i++){
         getline(file, line);
-        float x, y;
+        Real x, y;
         convert.str(line);
         convert >> x >> y;
         if (convert.fail()){
@@ -57,7 +64,7 @@ int Loader::LoadSegmentFromFile(std::vector<Vector2f>& segmentPoints, const std:
     return 1;
 }
 
-int Loader::LoadJustVerticesFromFile(std::vector<Vector2f>& vertices, const std::string& fileName, unsigned int numberVertices){
+int Loader::LoadJustVerticesFromFile(std::vector<Vector2r>& vertices, const std::string& fileName, unsigned int numberVertices){
     if (numberVertices == 0){
         LOG(LogLevel::ERROR) << "number of vertices should be a number greather than 0";
         return -2;
@@ -69,7 +76,7 @@ int Loader::LoadJustVerticesFromFile(std::vector<Vector2f>& vertices, const std:
     vertices.reserve(numberVertices);
     for (unsigned int i = 0; i < numberVertices; i++){
         getline(file, line);
-        float x, y;
+        Real x, y;
         convert.str(line);
         convert >> x >> y;
         if (convert.fail()){
@@ -87,7 +94,7 @@ int Loader::LoadJustVerticesFromFile(std::vector<Vector2f>& vertices, const std:
     return 1;
 }
 
-int Loader::LoadVerticesIndicesFromFile(std::vector<Vector2f>& vertices, std::vector<unsigned int>& indices,
+int Loader::LoadVerticesIndicesFromFile(std::vector<Vector2r>& vertices, std::vector<Index>& indices,
                                  const std::string& fileName, unsigned int numberVertices, bool loadIndices){
     if (numberVertices == 0){
         LOG(LogLevel::ERROR) << "number of vertices should be a number greather than 0";
@@ -101,7 +108,7 @@ int Loader::LoadVerticesIndicesFromFile(std::vector<Vector2f>& vertices, std::ve
     indices.reserve(numberVertices);
     for (unsigned int i = 0; i < numberVertices; i++){
         getline(file, line);
-        float x, y;
+        Real x, y;
         convert.str(line);
         convert >> x >> y;
         if (convert.fail()){
@@ -122,7 +129,7 @@ int Loader::LoadVerticesIndicesFromFile(std::vector<Vector2f>& vertices, std::ve
 
     if (!loadIndices){
         LOG(LogLevel::INFO) << "Correctly loaded default indices";
-        return 1;
+        return CheckSimplePolygon(vertices, indices, fileName);
     }
     OpenFileAndSearch(file, fileName, "indices");
     getline(file, line);
@@ -131,7 +138,7 @@ int Loader::LoadVerticesIndicesFromFile(std::vector<Vector2f>& vertices, std::ve
 
     for (unsigned int i = 0; i < numberVertices; i++){
         convert >> index;
-        if (convert.fail()){
+        if (convert.fail() || index >= numberVertices){
             LOG(LogLevel::ERROR) << "problems when reading indices";
             LOG(LogLevel::ERROR) << "Line: " << line;
             vertices.clear();
@@ -143,12 +150,26 @@ int Loader::LoadVerticesIndicesFromFile(std::vector<Vector2f>& vertices, std::ve
 
     file.close();
     LOG(LogLevel::INFO) << "Correctly loaded indices from " << fileName;
+    return CheckSimplePolygon(vertices, indices, fileName);
+}
+
+int Loader::CheckSimplePolygon(std::vector<Vector2r>& vertices, std::vector<Index>& indices, const std::string& fileName){
+    unsigned int firstEdge;
+    unsigned int secondEdge;
+    PolygonDefect defect = PolygonValidator::FindDefect(vertices, indices, firstEdge, secondEdge);
+    if (defect != PolygonDefect::None){
+        LOG(LogLevel::ERROR) << "polygon in " << fileName << " is not simple: " << defect
+                             << " (edges " << firstEdge << " and " << secondEdge << ")";
+        vertices.clear();
+        indices.clear();
+        return -4;
+    }
     return 1;
 }
 
-void Loader::SavePolygonToFile(const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices,
-                               const std::vector<Vector2f>& segmentPoints,
-                               const std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices,
+void Loader::SavePolygonToFile(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                               const std::vector<Vector2r>& segmentPoints,
+                               const PolygonSet& polygonsIndices,
                                const std::string& fileName){
     LOG(LogLevel::INFO) << "Saving polygon to " << fileName;
     unsigned int numberVertices = vertices.size();
@@ -159,6 +180,7 @@ void Loader::SavePolygonToFile(const std::vector<Vector2f>& vertices, const std:
         LOG(LogLevel::ERROR) << "failed to open file " << fileName;
         return;
     }
+    file.precision(Loader::COORDINATE_DIGITS);
     file << "# segment\n";
     file << segmentPoints[0].x << " " << segmentPoints[0].y << "\n";
     file << segmentPoints[1].x << " " << segmentPoints[1].y << "\n";
@@ -168,6 +190,7 @@ void Loader::SavePolygonToFile(const std::vector<Vector2f>& vertices, const std:
     for (unsigned int i = 0; i < numberIndices; i++){
         file << indices[i] << " ";
     }
+    file << "\n";
     file << "# vertices\n";
     for (unsigned int i = 0; i < numberVertices; i++){
         file << vertices[i].x << " " << vertices[i].y << "\n";
@@ -177,20 +200,14 @@ void Loader::SavePolygonToFile(const std::vector<Vector2f>& vertices, const std:
         unsigned int numberSmallPolygons = polygonsIndices.size();
         file << numberSmallPolygons << "\n";
         file << "# small polygons indices\n";
-        for (unsigned int i = 0; i < numberSmallPolygons; i++){
-            const std::vector<unsigned int>& smallIndices = *(polygonsIndices[i]);
-            for (unsigned int n = 0; n < smallIndices.size(); n++){
-                file << smallIndices[n] << " ";
-            }
-            file << "\n";
-        }
+        SavePolygonSet(file, polygonsIndices);
     }
     file.close();
     LOG(LogLevel::INFO) << "Polygon correctly saved";
 }
 
-void Loader::SaveElementToFile(const std::vector<Vector2f>& vertices,
-                               const std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices,
+void Loader::SaveElementToFile(const std::vector<Vector2r>& vertices,
+                               const PolygonSet& polygonsIndices,
                                const std::string& fileName){
 
     LOG(LogLevel::INFO) << "Saving element to " << fileName;
@@ -201,6 +218,7 @@ void Loader::SaveElementToFile(const std::vector<Vector2f>& vertices,
         LOG(LogLevel::ERROR) << "failed to open file " << fileName;
         return;
     }
+    file.precision(Loader::COORDINATE_DIGITS);
     file << "# number of vertices\n";
     file << numberVertices << "\n";
     file << "# vertices\n";
@@ -212,18 +230,62 @@ void Loader::SaveElementToFile(const std::vector<Vector2f>& vertices,
         unsigned int numberSmallPolygons = polygonsIndices.size();
         file << numberSmallPolygons << "\n";
         file << "# small polygons indices\n";
-        for (unsigned int i = 0; i < numberSmallPolygons; i++){
-            const std::vector<unsigned int>& smallIndices = *(polygonsIndices[i]);
-            for (unsigned int n = 0; n < smallIndices.size(); n++){
-                file << smallIndices[n] << " ";
-            }
-            file << "\n";
-        }
+        SavePolygonSet(file, polygonsIndices);
     }
     file.close();
     LOG(LogLevel::INFO) << "Element correctly saved";
 }
 
+void Loader::SaveMeshToFile(const std::vector<std::shared_ptr<std::vector<Vector2r>>>& vertices,
+                            const std::vector<IndicesElement>& indicesElement,
+                            const std::string& fileName){
+
+    LOG(LogLevel::INFO) << "Saving mesh to " << fileName;
+    unsigned int numberElements = indicesElement.size();
+    std::ofstream file;
+    file.open(fileName);
+    if (file.fail()){
+        LOG(LogLevel::ERROR) << "failed to open file " << fileName;
+        return;
+    }
+    file.precision(Loader::COORDINATE_DIGITS);
+    file << "# number of elements\n";
+    file << numberElements << "\n";
+    for (unsigned int e = 0; e < numberElements; e++){
+        const std::vector<Vector2r>& elementVertices = *vertices[e];
+        unsigned int numberVertices = elementVertices.size();
+        file << "# element " << e << "\n";
+        file << "# number of vertices\n";
+        file << numberVertices << "\n";
+        file << "# vertices\n";
+        for (unsigned int i = 0; i < numberVertices; i++){
+            file << elementVertices[i].x << " " << elementVertices[i].y << "\n";
+        }
+        const PolygonSet& insideIndices = *indicesElement[e].indicesInside;
+        file << "# number of inside polygons\n";
+        file << insideIndices.size() << "\n";
+        file << "# inside polygons indices\n";
+        SavePolygonSet(file, insideIndices);
+        const PolygonSet& outsideIndices = *indicesElement[e].indicesOutside;
+        file << "# number of outside polygons\n";
+        file << outsideIndices.size() << "\n";
+        file << "# outside polygons indices\n";
+        SavePolygonSet(file, outsideIndices);
+    }
+    file.close();
+    LOG(LogLevel::INFO) << "Mesh correctly saved";
+}
+
+void Loader::SavePolygonSet(std::ofstream& file, const PolygonSet& polygons){
+    // one line for each polygon
+    for (const PolygonView polygon : polygons){
+        for (unsigned int index : polygon){
+            file << index << " ";
+        }
+        file << "\n";
+    }
+}
+
 int Loader::GetNumberSmallPolygonsFromFile(const std::string& fileName){
     std::ifstream file;
     int found = OpenFileAndSearch(file, fileName, "number of small polygons");
@@ -244,7 +306,7 @@ int Loader::GetNumberSmallPolygonsFromFile(const std::string& fileName){
     return numberSmallPolygons;
 }
 
-int Loader::LoadSmallPolygonsIndicesFromFile(std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices,
+int Loader::LoadSmallPolygonsIndicesFromFile(PolygonSet& polygonsIndices,
                                              const std::string& fileName, unsigned int numberSmallPolygons){
     if (numberSmallPolygons == 0){
         LOG(LogLevel::ERROR) << "number of small polygons should be a number greather than 0";
@@ -259,15 +321,15 @@ int Loader::LoadSmallPolygonsIndicesFromFile(std::vector<std::shared_ptr<std::ve
     for (unsigned int i = 0; i < numberSmallPolygons; i++){
         getline(file, line);
         convert.str(line);
-        polygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>());
+        polygonsIndices.startPolygon();
         while (!convert.eof() && (convert >> index)){
-            if (convert.fail()){
+            if (convert.fail() || index >= PolygonSet::MAX_NUMBER_POINTS){
                 LOG(LogLevel::ERROR) << "problems when reading small polygons indices";
                 LOG(LogLevel::ERROR) << "Line: " << line;
                 polygonsIndices.clear();
                 return -3;
             }
-            polygonsIndices[i]->push_back(index);
+            polygonsIndices.addIndex(index);
         }
         convert.clear();
     }
@@ -298,3 +360,5 @@ int Loader::OpenFileAndSearch(std::ifstream& file, const std::string fileName, c
     }
     return 1;
 }
+
+const int Loader::COORDINATE_DIGITS = std::numeric_limits<Real>::max_digits10;
@@ -6,8 +6,8 @@
 #include <vector>
 #include <memory>
 
-#include "Vector2f.h"
-
+#include "Vector2.h"
+#include "PolygonSet.h"
 
 class Loader{
 
@@ -24,33 +24,45 @@ public:
     // return: positve number if read succesfuly a positive number, 0 or negative if number is negative or some error occurred
     static int GetNumberVerticesFromFile(const std::string& fileName);
     // return: 1 if loaded succesfuly, 0 or negative if some error occurred
-    static int LoadSegmentFromFile(std::vector<Vector2f>& segmentPoints, const std::string& fileName);
+    static int LoadSegmentFromFile(std::vector<Vector2r>& segmentPoints, const std::string& fileName);
 
-    static int LoadJustVerticesFromFile(std::vector<Vector2f>& vertices, const std::string& fileName, unsigned int numberVertices);
+    static int LoadJustVerticesFromFile(std::vector<Vector2r>& vertices, const std::string& fileName, unsigned int numberVertices);
 
-    // return: 1 if loaded succesfuly, 0 or negative if some error occurred
-    static int LoadVerticesIndicesFromFile(std::vector<Vector2f>& vertices, std::vector<unsigned int>& indices,
+    // return: 1 if loaded succesfuly, 0 or negative if some error occurred (-4 if the polygon is not simple)
+    static int LoadVerticesIndicesFromFile(std::vector<Vector2r>& vertices, std::vector<Index>& indices,
                                     const std::string& fileName, unsigned int numberVertices, bool loadIndices = false);
     // saves polygon to file (relative path is from the exectuable)
-    static void SavePolygonToFile(const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices,
-                                  const std::vector<Vector2f>& segmentPoints,
-                                  const std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices,
+    static void SavePolygonToFile(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                  const std::vector<Vector2r>& segmentPoints,
+                                  const PolygonSet& polygonsIndices,
                                   const std::string& fileName);
 
-    static void SaveElementToFile(const std::vector<Vector2f>& vertices,
-                                  const std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices,
+    static void SaveElementToFile(const std::vector<Vector2r>& vertices,
+                                  const PolygonSet& polygonsIndices,
                                   const std::string& fileName);
 
+    // saves every element of a cutted mesh with its inside and outside polygons
+    static void SaveMeshToFile(const std::vector<std::shared_ptr<std::vector<Vector2r>>>& vertices,
+                               const std::vector<IndicesElement>& indicesElement,
+                               const std::string& fileName);
+
     // return: positve number if read succesfuly a positive number, 0 or negative if number is negative or some error occurred
     static int GetNumberSmallPolygonsFromFile(const std::string& fileName);
 
     // return: positve number if read succesfuly a positive number, 0 or negative if number is negative or some error occurred
-    static int LoadSmallPolygonsIndicesFromFile(std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices,
+    static int LoadSmallPolygonsIndicesFromFile(PolygonSet& polygonsIndices,
                                                const std::string& fileName, unsigned int numberSmallPolygons);
 
 private:
     // return: 0 file not found 1 search found -1 search not found
     static int OpenFileAndSearch(std::ifstream& file, const std::string fileName, const std::string& search, bool drawError = true);
+    // writes the indices of every polygon on its own line
+    static void SavePolygonSet(std::ofstream& file, const PolygonSet& polygons);
+    // return: 1 if the polygon is simple, -4 if it is not and then vertices and indices are cleared
+    static int CheckSimplePolygon(std::vector<Vector2r>& vertices, std::vector<Index>& indices, const std::string& fileName);
+
+    // significant digits of the saved coordinates, enough to read back the same Real: 9 in float and 17 in double
+    static const int COORDINATE_DIGITS;
 };
 
 
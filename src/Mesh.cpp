@@ -1,42 +1,74 @@
 #include "Mesh.h"
+#include "FixedPoint.h"
 #include "Logger.h"
+#include <algorithm>
 
-Mesh::Mesh(const Element& _element, const std::vector<Vector2f> _verticesBorder,
-           unsigned int _numberX, unsigned int _numberY, float _elementWidth, float _elementHeight) :
-    verticesBorder(_verticesBorder), numberX(_numberX), numberY(_numberY),
+Mesh::Mesh(const Element& _element, const std::vector<Vector2r> _verticesBorder,
+           unsigned int _numberX, unsigned int _numberY, Real _elementWidth, Real _elementHeight, bool _fixedPoint) :
+    indices(_element.getPolygonsIndices()), verticesBorder(_verticesBorder), numberX(_numberX), numberY(_numberY),
     elementWidth(_elementWidth), elementHeight(_elementHeight),
-    numberElements(Mesh::debug ? 1 : numberX * numberY), numberPolygons(_element.getPolygonsIndices().size()){
+    numberElements(Mesh::debug ? 1 : numberX * numberY), numberPolygons(_element.getPolygonsIndices().size()),
+    fixedPoint(_fixedPoint){
 
-    Polygon::createBoundingBoxVariables(verticesBorder, width, height, xMin, yMin);
+    if (fixedPoint){
+        if (!FixedPoint::Quantize(verticesBorder)){
+            LOG(LogLevel::WARN) << "border is outside the grid of fixed point, it is moved inside";
+        }
+        elementWidth = FixedPoint::Quantize(elementWidth);
+        elementHeight = FixedPoint::Quantize(elementHeight);
+    }
 
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& _indices = _element.getPolygonsIndices();
+    Polygon::createBoundingBoxVariables(verticesBorder, width, height, xMin, yMin);
 
-    unsigned int indicesSize = _indices.size();
-    for (unsigned int i = 0; i < indicesSize; i++){
-        indices.push_back(_indices[i]);
-        //std::cout << indices[i]->size() << "\n";
+    std::vector<Index> indicesBorder;
+    for (unsigned int i = 0; i < verticesBorder.size(); i++){
+        indicesBorder.push_back(i);
+    }
+    preparedBorder.build(verticesBorder, indicesBorder);
+    borderConvex = Polygon::IsConvex(verticesBorder);
+    // the lines go around the border anti-clockwise, inside a convex border is on the left of all of them
+    const unsigned int numberVerticesBorder = verticesBorder.size();
+    for (unsigned int i = 0; i < numberVerticesBorder; i++){
+        const Vector2r& first = verticesBorder[i];
+        const Vector2r& second = verticesBorder[(i + 1) % numberVerticesBorder];
+        if (preparedBorder.isCounterclockwise()){
+            borderLines.push_back(Segment(first, second));
+        } else{
+            borderLines.push_back(Segment(second, first));
+        }
+    }
+    if (!borderConvex){
+        LOG(LogLevel::INFO) << "border is not convex, the elements are clipped with it";
     }
 
-    const std::vector<Vector2f>& _vertices = _element.getPoints();
-    float originalWidth  = _element.getWidth();
-    float originalHeight = _element.getHeight();
-    float originalXMin   = _element.getXMin();
-    float originalYMin   = _element.getYMin();
+    const std::vector<Vector2r>& _vertices = _element.getPoints();
+    Real originalWidth  = _element.getWidth();
+    Real originalHeight = _element.getHeight();
+    Real originalXMin   = _element.getXMin();
+    Real originalYMin   = _element.getYMin();
 
     Polygon::scaleXYMin(&originalXMin, &originalYMin, originalWidth, originalHeight, elementWidth, elementHeight);
 
+    std::vector<Vector2r> scaled = Polygon::scaleVertices(_vertices, originalWidth, originalHeight, elementWidth, elementHeight);
+    Real offsetX = xMin - originalXMin;
+    Real offsetY = yMin - originalYMin;
+    if (fixedPoint){
+        if (!FixedPoint::Quantize(scaled)){
+            LOG(LogLevel::WARN) << "element is outside the grid of fixed point, it is moved inside";
+        }
+        // the minimum of the quantized element is the quantized minimum, the difference is on the grid
+        offsetX = xMin - FixedPoint::Quantize(originalXMin);
+        offsetY = yMin - FixedPoint::Quantize(originalYMin);
+    }
+
     if (!debug){
         for (unsigned int x = 0; x < numberX; x++){
             for (unsigned int y = 0; y < numberY; y++){
-                vertices.push_back(Polygon::translateVerticesPointer(Polygon::scaleVertices(
-                                   _vertices, originalWidth, originalHeight, elementWidth, elementHeight),
-                                   xMin - originalXMin + x * elementWidth, yMin - originalYMin + y * elementHeight));
+                vertices.push_back(Polygon::translateVerticesPointer(scaled, offsetX + x * elementWidth, offsetY + y * elementHeight));
             }
         }
     } else{
-        vertices.push_back(Polygon::translateVerticesPointer(Polygon::scaleVertices(
-                           _vertices, originalWidth, originalHeight, elementWidth, elementHeight),
-                           xMin - originalXMin + xDebug * elementWidth, yMin - originalYMin + yDebug * elementHeight));
+        vertices.push_back(Polygon::translateVerticesPointer(scaled, offsetX + xDebug * elementWidth, offsetY + yDebug * elementHeight));
     }
 }
 
@@ -49,22 +81,22 @@ unsigned int Mesh::getNumberElements() const{
     return numberElements;
 }
 
-float Mesh::getWidth() const
+Real Mesh::getWidth() const
 {
     return width;
 }
 
-float Mesh::getHeight() const
+Real Mesh::getHeight() const
 {
     return height;
 }
 
-float Mesh::getXMin() const
+Real Mesh::getXMin() const
 {
     return xMin;
 }
 
-float Mesh::getYMin() const
+Real Mesh::getYMin() const
 {
     return yMin;
 }
@@ -79,7 +111,7 @@ unsigned int Mesh::getNumberY() const
     return numberY;
 }
 
-const std::vector<Vector2f>& Mesh::getVertices(unsigned int x, unsigned int y) const
+const std::vector<Vector2r>& Mesh::getVertices(unsigned int x, unsigned int y) const
 {
     if (x >= numberX){
         LOG(LogLevel::ERROR) << "x selected is greater than number of x, returned 0 instead";
@@ -92,7 +124,7 @@ const std::vector<Vector2f>& Mesh::getVertices(unsigned int x, unsigned int y) c
     return *vertices[x * numberY + y];
 }
 
-const std::vector<Vector2f>& Mesh::getVertices(unsigned int i) const
+const std::vector<Vector2r>& Mesh::getVertices(unsigned int i) const
 {
     if (i >= numberX * numberY){
         LOG(LogLevel::ERROR) << "i selected is greater than number of vertices, returned 0 instead";
@@ -101,30 +133,40 @@ const std::vector<Vector2f>& Mesh::getVertices(unsigned int i) const
     return *vertices[i];
 }
 
-const std::vector<std::shared_ptr<std::vector<Vector2f>>> Mesh::getAllVertices() const{
+const std::vector<std::shared_ptr<std::vector<Vector2r>>> Mesh::getAllVertices() const{
     return vertices;
 }
 
-const std::vector<std::shared_ptr<std::vector<unsigned int>>>& Mesh::getIndices() const{
+const PolygonSet& Mesh::getIndices() const{
     return indices;
 }
 
 std::vector<IndicesElement> Mesh::cut(){
-    std::vector<IndicesElement> elements;
-    for (unsigned int i = 0; i < numberElements; i++){
-        elements.push_back(cutElement(getVerticesPrivate(i), indices));
-        //std::cout << "finito x: " << x << " y: " << y << "\n";
-    }
-    return elements;
+    return cutAllElements(false);
 }
 
 std::vector<IndicesElement> Mesh::cutConcave(){
-    std::vector<IndicesElement> elements;
-    for (unsigned int i = 0; i < numberElements; i++){
-        elements.push_back(cutElement(getVerticesPrivate(i), indices, true));
-        //std::cout << "finito x: " << x << " y: " << y << "\n";
+    return cutAllElements(true);
+}
+
+bool Mesh::isBorderConvex() const{
+    return borderConvex;
+}
+
+bool Mesh::isFixedPoint() const{
+    return fixedPoint;
+}
+
+void Mesh::setNumberThreads(unsigned int number){
+    if (number == 1){
+        pool = nullptr;
+    } else{
+        pool = std::make_unique<ThreadPool>(number);
     }
-    return elements;
+}
+
+unsigned int Mesh::getNumberThreads() const{
+    return pool ? pool->getNumberThreads() : 1;
 }
 
 // STATIC
@@ -134,8 +176,6 @@ bool Mesh::debug = false;
 unsigned int Mesh::xDebug = 0;
 unsigned int Mesh::yDebug = 0;
 
-bool Mesh::forceConcave = false;
-
 void Mesh::setDebugMode(bool mode){
     debug = mode;
 }
@@ -148,107 +188,132 @@ void Mesh::setYDebug(unsigned int yD){
     yDebug = yD;
 }
 
-void Mesh::setForceConcave(bool mode){
-    forceConcave = mode;
+bool Mesh::IsSegmentInsideBox(const Vector2r& s1, const Vector2r& s2, Real boxXMin, Real boxYMin, Real boxXMax, Real boxYMax){
+    // first the bounding box of the segment
+    if (std::max(s1.x, s2.x) < boxXMin || std::min(s1.x, s2.x) > boxXMax ||
+        std::max(s1.y, s2.y) < boxYMin || std::min(s1.y, s2.y) > boxYMax){
+        return false;
+    }
+    // then the line of the segment, if all the corners are on the same side the segment does not enter the box
+    const Vector2r corners[4] = {{boxXMin, boxYMin}, {boxXMax, boxYMin}, {boxXMax, boxYMax}, {boxXMin, boxYMax}};
+    const Vector2r segment = s2 - s1;
+    bool positive = false;
+    bool negative = false;
+    for (const Vector2r& corner : corners){
+        double cross = segment.cross(corner - s1);
+        if (cross >= 0.0){
+            positive = true;
+        }
+        if (cross <= 0.0){
+            negative = true;
+        }
+    }
+    return positive && negative;
 }
 
 // PRIVATE
 
-void printElement(std::vector<Vector2f>& verticesElement){
+void printElement(std::vector<Vector2r>& verticesElement){
     std::cout << "vertices element\n";
     for (unsigned int l = 0; l < verticesElement.size(); l++){
         std::cout << l << ": x: " << verticesElement[l].x << " y: " << verticesElement[l].y << "\n";
     }
 }
 
-void printIndices(std::vector<unsigned int>& indices){
+void printIndices(std::vector<Index>& indices){
     std::cout << "vertices indices\n";
     for (unsigned int l = 0; l < indices.size(); l++){
         std::cout << l << ": " << indices[l] << "\n";
     }
 }
 
-IndicesElement Mesh::cutElement(std::vector<Vector2f>& verticesElement,
-                                const std::vector<std::shared_ptr<std::vector<unsigned int>>>& startIndices, bool concave){
-    if (Mesh::forceConcave == true){
-        concave = true;
+std::vector<IndicesElement> Mesh::cutAllElements(bool concave){
+    // every element is a translated copy of the same polygons, so an element the border does not touch
+    // is not cutted, it shares the indices of the element with the other elements in the same position
+    IndicesElement allInside{std::make_shared<const PolygonSet>(indices), std::make_shared<const PolygonSet>()};
+    IndicesElement allOutside{std::make_shared<const PolygonSet>(), std::make_shared<const PolygonSet>(indices)};
+
+    std::vector<IndicesElement> elements(numberElements);
+    auto cutOrShare = [this, &elements, &allInside, &allOutside, concave](unsigned int i){
+        std::vector<Vector2r>& verticesElement = getVerticesPrivate(i);
+        ElementPosition position = getElementPosition(verticesElement);
+        if (position == ElementPosition::Inside){
+            elements[i] = allInside;
+        } else if (position == ElementPosition::Outside){
+            elements[i] = allOutside;
+        } else{
+            elements[i] = cutElement(verticesElement, indices, concave);
+        }
+    };
+
+    if (!pool || numberElements < 2){
+        for (unsigned int i = 0; i < numberElements; i++){
+            cutOrShare(i);
+            //std::cout << "finito x: " << x << " y: " << y << "\n";
+        }
+    } else{
+        // every element has its own vertices and its own place in elements, so they can be cutted at the same time
+        pool->run(numberElements, cutOrShare);
     }
+    return elements;
+}
+
+ElementPosition Mesh::getElementPosition(const std::vector<Vector2r>& verticesElement) const{
+    Real widthElement;
+    Real heightElement;
+    Real xMinElement;
+    Real yMinElement;
+    Polygon::createBoundingBoxVariables(verticesElement, widthElement, heightElement, xMinElement, yMinElement);
+
+    // the box is a bit bigger so an element just touching the border is cutted as before
+    const Real margin = Vector2r::SOFT_TOLERANCE;
+    Real boxXMin = xMinElement - margin;
+    Real boxYMin = yMinElement - margin;
+    Real boxXMax = xMinElement + widthElement + margin;
+    Real boxYMax = yMinElement + heightElement + margin;
+
     unsigned int numberVerticesBorder = verticesBorder.size();
-    std::vector<unsigned int> indicesBorder;
     for (unsigned int i = 0; i < numberVerticesBorder; i++){
-        indicesBorder.push_back(i);
+        if (IsSegmentInsideBox(verticesBorder[i], verticesBorder[(i + 1) % numberVerticesBorder],
+                               boxXMin, boxYMin, boxXMax, boxYMax)){
+            return ElementPosition::Border;
+        }
     }
 
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<unsigned int>>>> indicesInside =
-                    std::make_shared<std::vector<std::shared_ptr<std::vector<unsigned int>>>>();
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<unsigned int>>>> indicesOutside =
-                    std::make_shared<std::vector<std::shared_ptr<std::vector<unsigned int>>>>();
-
-    for (unsigned int i = 0; i < numberPolygons; i++){
-        Polygon poly = Polygon(verticesElement, *(startIndices[i]));
-        poly.setSegment(verticesBorder[numberVerticesBorder - 1], verticesBorder[0]);
-//        poly.setSegment(verticesBorder[0], verticesBorder[1]);
-        poly.createNetworkMesh(verticesElement);
-        //printElement(verticesElement);
-        if (!concave){
-            poly.cutInsideOutside(*indicesInside, *indicesOutside);
-        } else{
-            poly.cutInsideOutsideConcave(*indicesInside, *indicesOutside, verticesBorder, indicesBorder, RelativePosition::Parallel);
-        }
+    // the border does not enter the box so the whole box is on the same side, the center is enough
+    const Vector2r center(xMinElement + widthElement / 2.0f, yMinElement + heightElement / 2.0f);
+    if (preparedBorder.isPointInsideExact(center)){
+        return ElementPosition::Inside;
     }
+    return ElementPosition::Outside;
+}
 
-//    std::cout << "OUTSIDE INDICES\n";
-//    for (unsigned int i = 0; i  < indicesOutside->size(); i++){
-//        std::vector<unsigned int>& indi = *indicesOutside->at(i);
-//        for (unsigned int q = 0; q < indi.size(); q++){
-//            std::cout << indi[q] << " ";
-//        }
-//        std::cout << "\n";
-//    }
-
-    if (true){
-//    for (unsigned int n = 1; n < 2; n++){
-        for (unsigned int n = 0; n < numberVerticesBorder - 1; n++){
-            std::shared_ptr<std::vector<std::shared_ptr<std::vector<unsigned int>>>> tmpIndicesInside =
-                            std::make_shared<std::vector<std::shared_ptr<std::vector<unsigned int>>>>();
-            std::shared_ptr<std::vector<std::shared_ptr<std::vector<unsigned int>>>> tmpIndicesOutside =
-                            std::make_shared<std::vector<std::shared_ptr<std::vector<unsigned int>>>>();
-            unsigned int numberIndicesInside = indicesInside->size();
-            unsigned int numberIndicesOutside = indicesOutside->size();
-            for (unsigned int i = 0; i < numberIndicesInside; i++){
-                Polygon poly = Polygon(verticesElement, *((*indicesInside)[i]));
-                poly.setSegment(verticesBorder[n], verticesBorder[n + 1]);
-                poly.createNetworkMesh(verticesElement);
-                if (!concave){
-                    poly.cutInsideOutside(*tmpIndicesInside, *tmpIndicesOutside);
-                } else{
-                    poly.cutInsideOutsideConcave(*tmpIndicesInside, *tmpIndicesOutside,
-                                                 verticesBorder, indicesBorder, RelativePosition::Positive);
-                }
+IndicesElement Mesh::cutElement(std::vector<Vector2r>& verticesElement,
+                                const PolygonSet& startIndices, bool concave){
+    const bool convex = borderConvex && !concave;
 
-            }
+    std::shared_ptr<PolygonSet> indicesInside = std::make_shared<PolygonSet>();
+    std::shared_ptr<PolygonSet> indicesOutside = std::make_shared<PolygonSet>();
 
-            for (unsigned int i = 0; i < numberIndicesOutside; i++){
-                Polygon poly = Polygon(verticesElement, *((*indicesOutside)[i]));
-                poly.setSegment(verticesBorder[n], verticesBorder[n + 1]);
-                poly.createNetworkMesh(verticesElement);
-                //poly.createNetwork();
-                if (!concave){
-                    poly.cutIndices(*tmpIndicesOutside);
-                } else{
-                    poly.cutInsideOutsideConcave(*tmpIndicesInside, *tmpIndicesOutside,
-                                                 verticesBorder, indicesBorder, RelativePosition::Negative);
-                }
-            }
-            indicesInside = tmpIndicesInside;
-            indicesOutside = tmpIndicesOutside;
+    // every polygon adds its intersection points to verticesElement, the grid is kept updated for all of them
+    PointGrid pointGrid(verticesElement);
+
+    for (unsigned int i = 0; i < numberPolygons; i++){
+        // the polygon uses verticesElement as its point pool, so it is not copied for every polygon
+        Polygon poly(&verticesElement, startIndices[i]);
+        if (convex){
+            // every polygon is cutted by the border lines, the pieces on the left of all of them are inside
+            poly.cutConvexBorder(borderLines, verticesElement, pointGrid, *indicesInside, *indicesOutside, fixedPoint);
+        } else{
+            // the border is walked once with the polygon, the pieces come out already inside or outside
+            poly.clipInsideOutside(preparedBorder, verticesElement, pointGrid, *indicesInside, *indicesOutside, fixedPoint);
         }
     }
     //std::cout << "number of vertices: " << verticesElement.size() << "\n";
     return {indicesInside, indicesOutside};
 }
 
-std::vector<Vector2f>& Mesh::getVerticesPrivate(unsigned int x, unsigned int y) const
+std::vector<Vector2r>& Mesh::getVerticesPrivate(unsigned int x, unsigned int y) const
 {
     if (x >= numberX){
         LOG(LogLevel::ERROR) << "x selected is greater than number of x, returned 0 instead";
@@ -261,7 +326,7 @@ std::vector<Vector2f>& Mesh::getVerticesPrivate(unsigned int x, unsigned int y)
     return *vertices[x * numberY + y];
 }
 
-std::vector<Vector2f>& Mesh::getVerticesPrivate(unsigned int i) const
+std::vector<Vector2r>& Mesh::getVerticesPrivate(unsigned int i) const
 {
     if (i >= numberX * numberY){
         LOG(LogLevel::ERROR) << "i selected is greater than number of vertices, returned 0 instead";
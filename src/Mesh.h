@@ -3,19 +3,25 @@
 
 #include "Element.h"
 #include "Segment.h"
+#include "ThreadPool.h"
 #include <vector>
 
 
-struct IndicesElement{
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<unsigned int>>>> indicesInside;
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<unsigned int>>>> indicesOutside;
+// position of an element with respect to the border, decided on the bounding box of the element
+enum class ElementPosition{
+    Inside,
+    Outside,
+    // the border crosses or touches the bounding box, the element has to be cutted
+    Border
 };
 
 class Mesh{
 
 public:
-    Mesh(const Element& _element, const std::vector<Vector2f> _verticesBorder,
-         unsigned int _numberX, unsigned int _numberY, float _elementWidth, float _elementHeight);
+    // with _fixedPoint the border and the elements are moved on the grid of FixedPoint and the cut snaps
+    // its points to it, the elements are moved by whole steps so all of them are cutted in the same way
+    Mesh(const Element& _element, const std::vector<Vector2r> _verticesBorder,
+         unsigned int _numberX, unsigned int _numberY, Real _elementWidth, Real _elementHeight, bool _fixedPoint = false);
 
     Mesh(const Mesh&)                 = delete;
     Mesh(Mesh&&) noexcept             = delete;
@@ -25,65 +31,89 @@ public:
     unsigned int getNumberPolygons() const;
     unsigned int getNumberElements() const;
 
-    float getWidth() const;
-    float getHeight() const;
+    Real getWidth() const;
+    Real getHeight() const;
 
-    float getXMin() const;
-    float getYMin() const;
+    Real getXMin() const;
+    Real getYMin() const;
 
     unsigned int getNumberX() const;
     unsigned int getNumberY() const;
 
-    const std::vector<Vector2f>& getVertices(unsigned int x, unsigned int y) const;
-    const std::vector<Vector2f>& getVertices(unsigned int i) const;
+    const std::vector<Vector2r>& getVertices(unsigned int x, unsigned int y) const;
+    const std::vector<Vector2r>& getVertices(unsigned int i) const;
 
-    const std::vector<std::shared_ptr<std::vector<Vector2f>>> getAllVertices() const;
+    const std::vector<std::shared_ptr<std::vector<Vector2r>>> getAllVertices() const;
 
-    const std::vector<std::shared_ptr<std::vector<unsigned int>>>& getIndices() const;
+    const PolygonSet& getIndices() const;
 
+    // the border is checked when the mesh is created: if it is convex the elements are cutted by its lines
+    // (Polygon::cutConvexBorder), otherwise they are clipped with it (Polygon::clipInsideOutside)
     std::vector<IndicesElement> cut();
+    // the elements are clipped with the border also if it is convex
     std::vector<IndicesElement> cutConcave();
+    bool isBorderConvex() const;
+    bool isFixedPoint() const;
+
+    // number of threads used to cut the elements, 0 uses one thread for each core, default is 1
+    // the elements are returned in the same order whatever the number of threads
+    void setNumberThreads(unsigned int number);
+    unsigned int getNumberThreads() const;
 
     static void setDebugMode(bool mode);
 
     static void setXDebug(unsigned int _xDebug);
     static void setYDebug(unsigned int _yDebug);
 
-    static void setForceConcave(bool mode);
-
 private:
-    std::vector<std::shared_ptr<std::vector<Vector2f>>> vertices;
-    std::vector<std::shared_ptr<std::vector<unsigned int>>> indices;
+    std::vector<std::shared_ptr<std::vector<Vector2r>>> vertices;
+    PolygonSet indices;
 
-    std::vector<Vector2f> verticesBorder;
+    std::vector<Vector2r> verticesBorder;
+    // line n passes through border vertices n and n + 1 (n + 1 and n if the border is clockwise)
+    std::vector<Segment> borderLines;
+    bool borderConvex;
+    // built once and shared by all the elements, they are clipped with it when the border is not convex
+    PreparedPolygon preparedBorder;
 
     unsigned int numberX;
     unsigned int numberY;
 
-    float elementWidth;
-    float elementHeight;
+    Real elementWidth;
+    Real elementHeight;
 
-    float width;
-    float height;
+    Real width;
+    Real height;
 
-    float xMin;
-    float yMin;
+    Real xMin;
+    Real yMin;
 
     const unsigned int numberElements;
     const unsigned int numberPolygons;
 
-    IndicesElement cutElement(std::vector<Vector2f>& verticesElement,
-                              const std::vector<std::shared_ptr<std::vector<unsigned int>>>& startIndices, bool concave = false);
+    const bool fixedPoint;
+
+    // nullptr when the elements are cutted by the calling thread
+    std::unique_ptr<ThreadPool> pool;
+
+    // concave: the elements are clipped with the border whatever its shape
+    std::vector<IndicesElement> cutAllElements(bool concave);
+
+    ElementPosition getElementPosition(const std::vector<Vector2r>& verticesElement) const;
+
+    IndicesElement cutElement(std::vector<Vector2r>& verticesElement,
+                              const PolygonSet& startIndices, bool concave);
 
-    std::vector<Vector2f>& getVerticesPrivate(unsigned int x, unsigned int y) const;
-    std::vector<Vector2f>& getVerticesPrivate(unsigned int i) const;
+    std::vector<Vector2r>& getVerticesPrivate(unsigned int x, unsigned int y) const;
+    std::vector<Vector2r>& getVerticesPrivate(unsigned int i) const;
 
     static bool debug;
 
     static unsigned int xDebug;
     static unsigned int yDebug;
 
-    static bool forceConcave;
+    // return: true if the segment has at least one point inside the box (border included)
+    static bool IsSegmentInsideBox(const Vector2r& s1, const Vector2r& s2, Real boxXMin, Real boxYMin, Real boxXMax, Real boxYMax);
 };
 
 #endif // MESH_H
@@ -1,11 +1,12 @@
 #include "Network.h"
 #include <iostream>
+#include <new>
 
-Node::Node(unsigned int _index) : touched{false}, next{nullptr}, previous{nullptr}, up{nullptr}, down{nullptr}, index{_index} {}
+Node::Node(Index _index) : touched{false}, next{nullptr}, previous{nullptr}, up{nullptr}, down{nullptr}, index{_index} {}
 
 Node::~Node() {}
 
-unsigned int Node::getIndex() const{
+Index Node::getIndex() const{
     return index;
 }
 
@@ -30,23 +31,80 @@ void Node::PrintNetwork(const Node* start, LogLevel level){
     } while (node != start);
 }
 
-void Node::DeleteNetwork(Node *start){
-    Node* node;
-    Node* tmp;
-    if (start != nullptr){
-        node = start->next;
-    } else{
-        LOG(LogLevel::ERROR) << "problems when deleting node network, start node is nullptr";
-        return;
-    }
-    while (node != start){
-        //LOG(LogLevel::DEBUG) << "deleted";
+NodePool::NodePool(unsigned int _blockSize) : blockSize{_blockSize > 0 ? _blockSize : 1}, currentBlock{0}, usedInBlock{0} {}
 
+NodePool::~NodePool(){
+    for (Node* block : blocks){
+        ::operator delete(block);
+    }
+}
 
-        tmp = node->next;
-        delete node;
-        node = tmp;
+Node* NodePool::create(Index index){
+    if (usedInBlock == blockSize){
+        currentBlock++;
+        usedInBlock = 0;
     }
-    delete start;
+    if (currentBlock == blocks.size()){
+        blocks.push_back(static_cast<Node*>(::operator new(sizeof(Node) * blockSize)));
+    }
+    return new (blocks[currentBlock] + usedInBlock++) Node(index);
+}
+
+void NodePool::clear(){
+    currentBlock = 0;
+    usedInBlock = 0;
+}
+
+unsigned int NodePool::getNumberNodes() const{
+    return currentBlock * blockSize + usedInBlock;
+}
+
+const unsigned int NodePool::BLOCK_SIZE = 256;
+
+Network::Network() {}
+
+unsigned int Network::create(Index _index){
+    unsigned int node = index.size();
+    index.push_back(_index);
+    next.push_back(NONE);
+    previous.push_back(NONE);
+    up.push_back(NONE);
+    down.push_back(NONE);
+    touched.push_back(false);
+    return node;
 }
 
+void Network::clear(){
+    index.clear();
+    next.clear();
+    previous.clear();
+    up.clear();
+    down.clear();
+    touched.clear();
+}
+
+void Network::reserve(unsigned int numberNodes){
+    index.reserve(numberNodes);
+    next.reserve(numberNodes);
+    previous.reserve(numberNodes);
+    up.reserve(numberNodes);
+    down.reserve(numberNodes);
+    touched.reserve(numberNodes);
+}
+
+unsigned int Network::getNumberNodes() const{
+    return index.size();
+}
+
+void Network::print(unsigned int start, LogLevel level) const{
+    unsigned int node = start;
+    unsigned int i = 0;
+    do{
+        if (node == NONE){
+            LOG(LogLevel::WARN) << i << ": is not linked";
+            return;
+        }
+        LOG(level) << i++ << ": " << getIndex(node);
+        node = next[node];
+    } while (node != start);
+}
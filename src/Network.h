@@ -2,7 +2,9 @@
 #define NETWORK_H
 
 #include <vector>
+#include <cstdint>
 #include "Logger.h"
+#include "PolygonSet.h"
 
 
 enum class NodeType{
@@ -16,7 +18,7 @@ enum class NodeType{
 class Node{
 
 public:
-    Node(unsigned int _index);
+    Node(Index _index);
     ~Node();
 
     Node(const Node&)                 = delete;
@@ -33,16 +35,101 @@ public:
     Node* up;
     Node* down;
 
-    unsigned int getIndex() const;
+    Index getIndex() const;
 
     bool isIntersection() const;
     bool isBetween() const;
 
     static void PrintNetwork(const Node* start, LogLevel level = LogLevel::INFO);
-    static void DeleteNetwork(Node* start);
 
 private:
-    unsigned int index;
+    Index index;
+};
+
+// arena where the nodes of a network are created
+// creating a node just moves forward inside a block and clear releases every node at once,
+// the blocks are kept so a pool can be reused for many networks without allocating again
+// the nodes are never destroyed one by one so Node has to stay without resources to release
+class NodePool{
+
+public:
+    NodePool(unsigned int _blockSize = NodePool::BLOCK_SIZE);
+    ~NodePool();
+
+    NodePool(const NodePool&)                 = delete;
+    NodePool(NodePool&&) noexcept             = delete;
+    NodePool& operator=(const NodePool&)      = delete;
+    NodePool& operator=(NodePool&&) noexcept  = delete;
+
+    Node* create(Index index);
+
+    // every node created before is no longer valid
+    void clear();
+
+    unsigned int getNumberNodes() const;
+
+    static const unsigned int BLOCK_SIZE;
+
+private:
+    std::vector<Node*> blocks;
+    unsigned int blockSize;
+    // block where the next node is created and number of nodes already created in it
+    unsigned int currentBlock;
+    unsigned int usedInBlock;
+};
+
+// network of nodes stored as structure of arrays, a node is just its position in the arrays
+// it has the same links as Node (next, previous, up, down) but walking the network reads contiguous memory
+// and copying a network copies five arrays of integers and a bitset
+class Network{
+
+public:
+    Network();
+
+    Network(const Network&)                 = default;
+    Network(Network&&) noexcept             = default;
+    Network& operator=(const Network&)      = default;
+    Network& operator=(Network&&) noexcept  = default;
+
+    // used instead of nullptr when a node is not linked
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // every node
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> previous;
+    //just for parallel nodes
+    std::vector<uint32_t> up;
+    std::vector<uint32_t> down;
+
+    std::vector<bool> touched;
+
+    // return the new node, it is not linked to any other node
+    unsigned int create(Index index);
+
+    // every node created before is no longer valid, the memory is kept for the next network
+    void clear();
+    void reserve(unsigned int numberNodes);
+
+    unsigned int getNumberNodes() const;
+
+    // small functions used in every step of the traversal so they are defined here
+    Index getIndex(unsigned int node) const{
+        return index[node];
+    }
+
+    bool isIntersection(unsigned int node) const{
+        return up[node] != NONE || down[node] != NONE;
+    }
+
+    bool isBetween(unsigned int node) const{
+        return next[node] == NONE || previous[node] == NONE;
+    }
+
+    void print(unsigned int start, LogLevel level = LogLevel::INFO) const;
+
+private:
+    // index of the point of every node, the links above are positions of nodes
+    std::vector<Index> index;
 };
 
 #endif // NETWORK_H
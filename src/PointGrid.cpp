@@ -0,0 +1,71 @@
+#include "PointGrid.h"
+#include <math.h>
+
+PointGrid::PointGrid() : numberPoints{0} {}
+
+PointGrid::PointGrid(const std::vector<Vector2r>& points) : numberPoints{0} {
+    build(points);
+}
+
+void PointGrid::build(const std::vector<Vector2r>& points){
+    cells.clear();
+    numberPoints = 0;
+    unsigned int size = points.size();
+    for (unsigned int i = 0; i < size; i++){
+        add(points[i], i);
+    }
+}
+
+void PointGrid::add(const Vector2r& point, unsigned int index){
+    cells[GetKey(GetCell(point.x), GetCell(point.y))].push_back(index);
+    numberPoints++;
+}
+
+bool PointGrid::find(const Vector2r& point, const std::vector<Vector2r>& points, unsigned int& index,
+                     double tolerance) const{
+    int32_t cellX = GetCell(point.x);
+    int32_t cellY = GetCell(point.y);
+    bool found = false;
+    for (int32_t x = cellX - 1; x <= cellX + 1; x++){
+        for (int32_t y = cellY - 1; y <= cellY + 1; y++){
+            auto cell = cells.find(GetKey(x, y));
+            if (cell == cells.end()){
+                continue;
+            }
+            // indices in a cell are in increasing order so the first one that matches is the lowest of the cell
+            for (unsigned int i : cell->second){
+                if (found && i >= index){
+                    break;
+                }
+                if ((point - points[i]).normSquared() < tolerance){
+                    index = i;
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+unsigned int PointGrid::getNumberPoints() const{
+    return numberPoints;
+}
+
+const double PointGrid::CELL_SIZE = 2.0 * sqrt(Vector2r::TOLERANCE);
+
+int32_t PointGrid::GetCell(Real coordinate){
+    double cell = floor(coordinate / PointGrid::CELL_SIZE);
+    // points really far away share the last cells, one is left free on each side for the cells around
+    if (!(cell > INT32_MIN + 1)){
+        return INT32_MIN + 1;
+    }
+    if (cell > INT32_MAX - 1){
+        return INT32_MAX - 1;
+    }
+    return (int32_t)cell;
+}
+
+uint64_t PointGrid::GetKey(int32_t x, int32_t y){
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
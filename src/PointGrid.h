@@ -0,0 +1,49 @@
+#ifndef POINTGRID_H
+#define POINTGRID_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Vector2.h"
+
+
+// hash grid over an array of points, used to find if a point is already in the array without scanning all of it
+// two points are the same if the squared distance between them is less than Vector2r::TOLERANCE,
+// cells are twice that distance wide so a point can only match points in its cell and in the 8 around it
+// the grid stores just the indices so it has to be updated every time a point is added to the array
+class PointGrid{
+
+public:
+    PointGrid();
+    PointGrid(const std::vector<Vector2r>& points);
+
+    PointGrid(const PointGrid&)                 = delete;
+    PointGrid(PointGrid&&) noexcept             = delete;
+    PointGrid& operator=(const PointGrid&)      = delete;
+    PointGrid& operator=(PointGrid&&) noexcept  = delete;
+
+    // remove every point and add the points of the array
+    void build(const std::vector<Vector2r>& points);
+
+    // the point has to be the next one of the array, index is its position in it
+    void add(const Vector2r& point, unsigned int index);
+
+    // return: true if a point of the array is the same as point, index is set to the lowest of them
+    // it is the same point a linear scan of the array would find
+    // tolerance is the squared distance of two same points, it can not be greater than Vector2r::TOLERANCE
+    bool find(const Vector2r& point, const std::vector<Vector2r>& points, unsigned int& index,
+              double tolerance = Vector2r::TOLERANCE) const;
+
+    unsigned int getNumberPoints() const;
+
+    static const double CELL_SIZE;
+
+private:
+    std::unordered_map<uint64_t, std::vector<unsigned int>> cells;
+    unsigned int numberPoints;
+
+    static int32_t GetCell(Real coordinate);
+    static uint64_t GetKey(int32_t x, int32_t y);
+};
+
+#endif // POINTGRID_H
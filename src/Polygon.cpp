@@ -1,37 +1,67 @@
 #include "Polygon.h"
+#include "Predicates.h"
+#include "FixedPoint.h"
 #include "Logger.h"
 #include <math.h>
 #include <iostream>
 #include <exception>
+#include <algorithm>
+#include <unordered_set>
 
-Polygon::Polygon() : startNode{nullptr} {}
+Polygon::Polygon() : points{ownPoints}, numberBodyPoints{0}, network{&ownNetwork}, startNode{Network::NONE}, firstNode{Network::NONE},
+                     numberIntersections{0}, alsoSegmentPoints{false} {}
 
-Polygon::Polygon(const std::vector<Vector2f>& _points, const std::vector<unsigned int>& _indices) :
-    points(_points), indices(_indices), startNode(nullptr), alsoSegmentPoints(false) {
+Polygon::Polygon(const std::vector<Vector2r>& _points, const std::vector<Index>& _indices) :
+    ownPoints(_points), points(ownPoints), indices(_indices), numberBodyPoints(_points.size()), network(&ownNetwork),
+    startNode(Network::NONE), firstNode(Network::NONE), numberIntersections(0), alsoSegmentPoints(false) {
 
     Polygon::createBoundingBoxVariables(points, width, height, xMin, yMin);
 
     checkEnoughPointIndices();
 }
 
+Polygon::Polygon(std::vector<Vector2r>* pointPool, PolygonView _indices) :
+    points(*pointPool), indices(_indices.begin(), _indices.end()), numberBodyPoints(pointPool->size()), network(&ownNetwork),
+    startNode(Network::NONE), firstNode(Network::NONE), numberIntersections(0), alsoSegmentPoints(false) {
+
+    // the pool can have a lot more points than the polygon, only its own are looked at
+    Polygon::createBoundingBoxVariables(points, indices, width, height, xMin, yMin);
+
+    checkEnoughPointIndices();
+}
+
 Polygon::~Polygon(){
     deleteStartNode();
 }
 
-void Polygon::setBody(const std::vector<Vector2f>& _points, const std::vector<unsigned int>& _indices){
+void Polygon::setBody(const std::vector<Vector2r>& _points, const std::vector<Index>& _indices){
+    if (hasPointPool()){
+        LOG(LogLevel::ERROR) << "the body of a polygon with a point pool can not be changed";
+        return;
+    }
     points = _points;
     indices = _indices;
+    numberBodyPoints = points.size();
+    edgeTree = nullptr;
+    // the edges of the body before are made again for the next segment
+    workspace.bodyEdges.x1.clear();
+    workspace.preparedBody = nullptr;
     Polygon::createBoundingBoxVariables(points, width, height, xMin, yMin);
 
     checkEnoughPointIndices();
 }
 
-void Polygon::setSegment(const Vector2f& _p1, const Vector2f& _p2){
+void Polygon::setSegment(const Vector2r& _p1, const Vector2r& _p2){
     p1 = _p1;
     p2 = _p2;
 }
 
-const Vector2f& Polygon::getPoint(unsigned int index) const{
+void Polygon::setNetwork(Network* sharedNetwork){
+    deleteStartNode();
+    network = sharedNetwork != nullptr ? sharedNetwork : &ownNetwork;
+}
+
+const Vector2r& Polygon::getPoint(unsigned int index) const{
     if (index >= getNumberIndices()){
         LOG(LogLevel::ERROR) << "Polygon::getPoint: Array out of bound, returned point(0) instead";
         return points[0];
@@ -43,22 +73,26 @@ unsigned int Polygon::getNumberIndices() const{
     return indices.size();
 }
 
-const std::vector<Vector2f>& Polygon::getPoints() const{
+const std::vector<Vector2r>& Polygon::getPoints() const{
     return points;
 }
 
-const std::vector<unsigned int>& Polygon::getIndices() const{
+const std::vector<Index>& Polygon::getIndices() const{
     return indices;
 }
 
-std::vector<Vector2f> Polygon::getSegment() const{
+std::vector<Vector2r> Polygon::getSegment() const{
     return {p1, p2};
 }
 
-const Node* Polygon::getStartNode() const{
+unsigned int Polygon::getStartNode() const{
     return startNode;
 }
 
+const Network& Polygon::getNetwork() const{
+    return *network;
+}
+
 unsigned int Polygon::getNumberIntersections() const{
     return numberIntersections;
 }
@@ -79,244 +113,181 @@ void Polygon::printIndices(LogLevel level) const{
 
 void Polygon::printNetwork(LogLevel level) const{
     LOG(level) << "Printing polygon network";
-    Node::PrintNetwork(startNode, level);
+    network->print(startNode, level);
 }
 
 void Polygon::printNetworkWithCoordinates(LogLevel level) const{
     LOG(level) << "Printing polygon network with coordinates";
-    const Node* start = startNode;
-    const Node* node = start;
+    const unsigned int start = startNode;
+    unsigned int node = start;
     unsigned int i = 0;
     do{
-        if (node == nullptr){
-            LOG(LogLevel::WARN) << i << ": is nullptr";
+        if (node == Network::NONE){
+            LOG(LogLevel::WARN) << i << ": is not linked";
             return;
         }
-        unsigned int index = node->getIndex();
+        unsigned int index = network->getIndex(node);
         LOG(level) << i++ << ": " << index << " x: " << points[index].x << " y: " << points[index].y;
-        node = node->next;
+        node = network->next[node];
     } while (node != start);
 }
 
-void Polygon::createNetwork(bool addSegmentPoints){
-    alsoSegmentPoints = addSegmentPoints;
-    // stores the intersection Nodes in order to sort them after
-    std::vector<Node*> unorderedIntersectionNodes;
-    // intersector is used to find intersection points
-    Intersector inter;
-    // this is the segment, it will be treated as a line when computing intersection
-    inter.setSegment1(p1, p2);
-
-    numberIntersections = 0;
-
-    // this vector is used to find the one of the two most external intersection node
-    // precisely the last the segment line intersects
-    // it is useful for helping the sorting  of the intersection nodes after
-    Vector2f segment = p2 - p1;
-    // in order to find this node we will compute the dot product with the segment
-    // and one of point of the segment - the intersection node
-    double minProduct = Polygon::BIG_DOUBLE;
-    Node* minIntersectionNode = nullptr;
-
-    // this stores the first normal node, in order to connect it in the end to the last node (the network is cyclical)
-    firstNode = nullptr;
-    // this stores the pointer to the temporary node we are considering
-    Node* node = nullptr;
-    // this stores the pointer to the previous node se we can connect it with the new one
-    Node* previous = nullptr;
-
-    // we store the node that could be intersection on vertex
-    // this has to be done because when we find an intersection on vertex, it could be on the first or the second vertex
-    // so we add the two vertices to this list of possible vertices then at the end we look for vertices whose previous's up are themselves
-    // that is if the vertex before on the list point to the specific vertex then we know this last one is an intersection point
-    std::vector<Node*> possibleOnVertex;
-
-    unsigned int numberIndices = getNumberIndices();
+void Polygon::createEdgeTree(){
+    edgeTree = std::make_unique<EdgeTree>(points, indices);
+}
 
-    for (unsigned int i = 0; i < numberIndices; i++){
-        node = new Node(indices[i]);
-        // previous will be nullptr just the first time
-        if (previous != nullptr){
-            node->previous = previous;
-            previous->next = node;
-        } else{
-            //LOG(LogLevel::DEBUG) << "first node setted";
-            firstNode = node;
+// point policy of createNetwork, every intersection point is a new point of the polygon
+// with segment points the points of the segment inside the polygon are added to the small polygons too
+template<bool addSegmentPoints>
+struct Polygon::NewPoints{
+    static constexpr bool SEGMENT_POINTS = addSegmentPoints;
+    static constexpr bool ANTI_CLOCKWISE = false;
+
+    unsigned int addPoint(Polygon& polygon, const Vector2r& point){
+        polygon.points.push_back(point);
+        if (polygon.points.size() == PolygonSet::MAX_NUMBER_POINTS + 1){
+            LOG(LogLevel::ERROR) << "more than " << PolygonSet::MAX_NUMBER_POINTS << " points, the indices are too narrow";
         }
-        // here we set previous to node beacuse in the next iteration will be previous
-        previous = node;
-        // we calculate the intersection with the segment from the point to the next one
-        inter.setSegment2(points[indices[i]], points[indices[(i + 1) % numberIndices]]);
-        IntersectionType intersectionType = inter.calculateIntersection(true, false);
+        return polygon.points.size() - 1;
+    }
+};
 
-        // we separete the two cases when the intersection point is inside the segement
-        // (if it is inside the segment intended as segment but on the vertex of the segment intended as line,
-        // intersection point is FirstOnVertex (or SecondOnVertex if the two segment were swapped))
-        bool isInsideSegment = intersectionType == IntersectionType::InsideSegment || intersectionType == IntersectionType::FirstOnVertex;
-        bool isOnVertex = intersectionType == IntersectionType::BothOnVertex || intersectionType == IntersectionType::SecondOnVertex;
+// point policy of createNetworkMesh, an intersection point is searched in the points of the polygons near
+// so polygons that share an edge share the point too
+struct Polygon::SharedPoints{
+    static constexpr bool SEGMENT_POINTS = false;
+    static constexpr bool ANTI_CLOCKWISE = true;
 
-        if (isInsideSegment){
-            const Vector2f intersectionPoint = inter.getIntersectionPoint();
-            // we add the new point found to the points of the polygon
-            points.push_back(intersectionPoint);
-            // index of last point before intersection was numberIndices - 1 so the first intersection node starts from numberIndices
-            //node = new Node(numberIndices + numberIntersections);
-            node = new Node(points.size() - 1);
-            // we add the new node found to the list of unordered intersection nodes
-            unorderedIntersectionNodes.push_back(node);
-            numberIntersections++;
-            // again we connect it with the previous node because intersection nodes are connected both
-            // like the normal nodes to previous and after
-            // but are also connected between them with up and down
-            node->previous = previous;
-            previous->next = node;
-            previous = node;
+    std::vector<Vector2r>& extraPoint;
+    PointGrid& grid;
 
-            // here is calculated the dot product in order to find the most outer intersection node
-            double product = segment.dot(points[node->getIndex()] - p1);
-            if (product < minProduct){
-                minIntersectionNode = node;
-                minProduct = product;
-            }
-        } else if (isOnVertex){
-            possibleOnVertex.push_back(node);
-        }
+    unsigned int addPoint(Polygon& polygon, const Vector2r& point){
+        return polygon.findOrAddPoint(point, extraPoint, grid);
     }
+};
 
-    if (firstNode == nullptr){
-        LOG(LogLevel::ERROR) << "first node is nullptr";
-        return;
+void Polygon::createNetwork(bool addSegmentPoints){
+    // intersection points of the segment cutted before are not needed anymore
+    // (in a point pool they can be used by other polygons)
+    if (!hasPointPool()){
+        points.resize(numberBodyPoints);
     }
-    // finally we connect the first node with the last one and the cycle is closed
-    firstNode->previous = previous;
-    previous->next = firstNode;
-
-    unsigned int numberPossibleOnVertex = possibleOnVertex.size();
-    for (unsigned int i = 0; i < numberPossibleOnVertex; i++){
-        if (possibleOnVertex[(i - 1) % numberPossibleOnVertex]->next == possibleOnVertex[i]){
-            Node* nodeAdd = possibleOnVertex[i];
 
-            if (checkIsPointIntersection(nodeAdd)){
-                unorderedIntersectionNodes.push_back(nodeAdd);
-                numberIntersections++;
-
-                // here is calculated the dot product in order to find the most outer intersection node
-                double product = segment.dot(points[nodeAdd->getIndex()] - p1);
-                if (product < minProduct){
-                    minIntersectionNode = nodeAdd;
-                    minProduct = product;
-                }
-            }
-        }
+    if (addSegmentPoints){
+        NewPoints<true> pointPolicy;
+        buildNetwork(pointPolicy);
+    } else{
+        NewPoints<false> pointPolicy;
+        buildNetwork(pointPolicy);
     }
+}
 
-    // here we handle the case where there are no intersections
-    if (minIntersectionNode != nullptr){
-        startNode = minIntersectionNode;
-        sortIntersectionsNetwork(unorderedIntersectionNodes);
+void Polygon::createNetworkMesh(std::vector<Vector2r>& extraPoint){
+    PointGrid grid(points);
+    createNetworkMesh(extraPoint, grid);
+}
 
-        if (addSegmentPoints){
-            addSegmentPointsToNetwork();
-        }
+void Polygon::createNetworkMesh(std::vector<Vector2r>& extraPoint, PointGrid& grid){
+    if (extraPoint.size() != points.size()){
+        LOG(LogLevel::WARN) << "points and extra points do not have the same size";
+    }
+    if (grid.getNumberPoints() != points.size()){
+        LOG(LogLevel::WARN) << "grid does not index the points of the polygon, it is built again";
+        grid.build(points);
+    }
 
-        calculateOrientation();
+    SharedPoints pointPolicy{extraPoint, grid};
+    buildNetwork(pointPolicy);
+}
 
-        LOG::NewLine(LogLevel::INFO);
+template<typename PointPolicy>
+void Polygon::buildNetwork(PointPolicy& pointPolicy){
+    Network& net = *network;
+    // the nodes of a previous network are released all together
+    net.clear();
+    alsoSegmentPoints = PointPolicy::SEGMENT_POINTS;
 
-    } else if (numberIntersections == 0){
-        LOG(LogLevel::INFO) << "No intersections";
-        startNode = firstNode;
-    } else{
-        LOG(LogLevel::ERROR) << "problems when setting startNode";
-        startNode = firstNode;
+    numberIntersections = 0;
+    if constexpr (PointPolicy::ANTI_CLOCKWISE){
+        // orientation has to be set to positive because this mode only support anti-clock wise indices
+        orientation = RelativePosition::Positive;
     }
-}
-
-void Polygon::createNetworkMesh(std::vector<Vector2f>& extraPoint){
-    if (extraPoint.size() != points.size()){
-        LOG(LogLevel::WARN) << "points and extra points do not have the same size";
+    if (isSegmentLineAwayFromBox()){
+        // no network is needed, the polygon is returned whole
+        LOG(LogLevel::INFO) << "Segment line does not touch the bounding box";
+        firstNode = Network::NONE;
+        startNode = Network::NONE;
+        return;
     }
 
     // stores the intersection Nodes in order to sort them after
-    std::vector<Node*> unorderedIntersectionNodes;
+    std::vector<unsigned int>& unorderedIntersectionNodes = workspace.unorderedIntersectionNodes;
+    unorderedIntersectionNodes.clear();
     // intersector is used to find intersection points
     Intersector inter;
     // this is the segment, it will be treated as a line when computing intersection
     inter.setSegment1(p1, p2);
 
-    numberIntersections = 0;
-
     // this vector is used to find the one of the two most external intersection node
     // precisely the last the segment line intersects
     // it is useful for helping the sorting  of the intersection nodes after
-    Vector2f segment = p2 - p1;
+    Vector2r segment = p2 - p1;
     // in order to find this node we will compute the dot product with the segment
     // and one of point of the segment - the intersection node
     double minProduct = Polygon::BIG_DOUBLE;
-    Node* minIntersectionNode = nullptr;
+    unsigned int minIntersectionNode = Network::NONE;
 
     // this stores the first normal node, in order to connect it in the end to the last node (the network is cyclical)
-    firstNode = nullptr;
-    // this stores the pointer to the temporary node we are considering
-    Node* node = nullptr;
-    // this stores the pointer to the previous node se we can connect it with the new one
-    Node* previous = nullptr;
+    firstNode = Network::NONE;
+    // this stores the temporary node we are considering
+    unsigned int node = Network::NONE;
+    // this stores the previous node se we can connect it with the new one
+    unsigned int previous = Network::NONE;
 
     // we store the node that could be intersection on vertex
     // this has to be done because when we find an intersection on vertex, it could be on the first or the second vertex
     // so we add the two vertices to this list of possible vertices then at the end we look for vertices whose previous's up are themselves
     // that is if the vertex before on the list point to the specific vertex then we know this last one is an intersection point
-    std::vector<Node*> possibleOnVertex;
+    std::vector<unsigned int>& possibleOnVertex = workspace.possibleOnVertex;
+    possibleOnVertex.clear();
 
     unsigned int numberIndices = getNumberIndices();
+    net.reserve(numberIndices);
+
+    // every edge is intersected with the segment line at once, then the network is created edge after edge
+    std::vector<LineSegmentIntersection>& intersectionTypes = workspace.intersectionTypes;
+    std::vector<Vector2r>& intersectionPoints = workspace.intersectionPoints;
+    calculateEdgeIntersections(inter, intersectionTypes, intersectionPoints);
 
     for (unsigned int i = 0; i < numberIndices; i++){
-        node = new Node(indices[i]);
-        // previous will be nullptr just the first time
-        if (previous != nullptr){
-            node->previous = previous;
-            previous->next = node;
+        node = net.create(indices[i]);
+        // previous will be not linked just the first time
+        if (previous != Network::NONE){
+            net.previous[node] = previous;
+            net.next[previous] = node;
         } else{
-
             firstNode = node;
         }
         // here we set previous to node beacuse in the next iteration will be previous
         previous = node;
-        // we calculate the intersection with the segment from the point to the next one
-        inter.setSegment2(points[indices[i]], points[indices[(i + 1) % numberIndices]]);
-        IntersectionType intersectionType = inter.calculateIntersection(true, false);
+        // this is the intersection with the segment from the point to the next one
+        const LineSegmentIntersection intersectionType = intersectionTypes[i];
 
         // we separete the two cases when the intersection point is inside the segement
-        // (if it is inside the segment intended as segment but on the vertex of the segment intended as line,
-        // intersection point is FirstOnVertex (or SecondOnVertex if the two segment were swapped))
-        bool isInsideSegment = intersectionType == IntersectionType::InsideSegment || intersectionType == IntersectionType::FirstOnVertex;
-        bool isOnVertex = intersectionType == IntersectionType::BothOnVertex || intersectionType == IntersectionType::SecondOnVertex;
+        // (the segment is treated as a line so the intersection can only be on the vertices of the edge,
+        // FirstVertex and SecondVertex are what calculateIntersection(true, false) calls SecondOnVertex)
+        bool isInsideSegment = intersectionType == LineSegmentIntersection::InsideSegment;
+        bool isOnVertex = intersectionType == LineSegmentIntersection::FirstVertex || intersectionType == LineSegmentIntersection::SecondVertex;
 
         if (isInsideSegment){
-            // if it is inside the segment we search if the intersection point is already in the points
-            // if it is we create a new Node pointing to that point, else we create also a new point
-
-            const Vector2f intersectionPoint = inter.getIntersectionPoint();
-
-            bool found = false;
-            for (unsigned int l = 0; l < points.size(); l++){
-                if ((intersectionPoint - points[l]).normSquared() < Vector2f::TOLERANCE){
-                    node = new Node(l);
-                    found = true;
-                    break;
-                }
-            }
-            if (!found){
-                points.push_back(intersectionPoint);
-                extraPoint.push_back(intersectionPoint);
-                node = new Node(points.size() - 1);
-            }
+            // the point policy decides if the intersection point is a new point or one already there
+            node = net.create(pointPolicy.addPoint(*this, intersectionPoints[i]));
 
             // again we connect it with the previous node because intersection nodes are connected both
             // like the normal nodes to previous and after
             // but are also connected between them with up and down
-            node->previous = previous;
-            previous->next = node;
+            net.previous[node] = previous;
+            net.next[previous] = node;
             previous = node;
 
             // we add the new node found to the list of unordered intersection nodes
@@ -324,7 +295,7 @@ void Polygon::createNetworkMesh(std::vector<Vector2f>& extraPoint){
             numberIntersections++;
 
             // here is calculated the dot product in order to find the most outer intersection node
-            double product = segment.dot(points[node->getIndex()] - p1);
+            double product = segment.dot(points[net.getIndex(node)] - p1);
             if (product < minProduct){
                 minIntersectionNode = node;
                 minProduct = product;
@@ -334,25 +305,25 @@ void Polygon::createNetworkMesh(std::vector<Vector2f>& extraPoint){
         }
     }
 
-    if (firstNode == nullptr){
-        LOG(LogLevel::ERROR) << "first node is nullptr";
+    if (firstNode == Network::NONE){
+        LOG(LogLevel::ERROR) << "first node is not linked";
         return;
     }
     // finally we connect the first node with the last one and the cycle is closed
-    firstNode->previous = previous;
-    previous->next = firstNode;
+    net.previous[firstNode] = previous;
+    net.next[previous] = firstNode;
 
     unsigned int numberPossibleOnVertex = possibleOnVertex.size();
     for (unsigned int i = 0; i < numberPossibleOnVertex; i++){
-        if (possibleOnVertex[(i - 1) % numberPossibleOnVertex]->next == possibleOnVertex[i]){
-            Node* nodeAdd = possibleOnVertex[i];
+        if (net.next[possibleOnVertex[(i - 1) % numberPossibleOnVertex]] == possibleOnVertex[i]){
+            unsigned int nodeAdd = possibleOnVertex[i];
 
             if (checkIsPointIntersection(nodeAdd)){
                 unorderedIntersectionNodes.push_back(nodeAdd);
                 numberIntersections++;
 
                 // here is calculated the dot product in order to find the most outer intersection node
-                double product = segment.dot(points[nodeAdd->getIndex()] - p1);
+                double product = segment.dot(points[net.getIndex(nodeAdd)] - p1);
                 if (product < minProduct){
                     minIntersectionNode = nodeAdd;
                     minProduct = product;
@@ -361,22 +332,29 @@ void Polygon::createNetworkMesh(std::vector<Vector2f>& extraPoint){
         }
     }
 
-    // orientation has to be set to positive because this mode only support anti-clock wise indices
-    orientation = RelativePosition::Positive;
+    // with anti-clockwise indices only one intersection means that the segment is tangent to the polygon
+    // (this happens when the points and indices are manually entered), it is handled as when there are no intersections
+    const unsigned int minimumIntersections = PointPolicy::ANTI_CLOCKWISE ? 2 : 1;
 
     // here we handle the case where there are no intersections
-    if (minIntersectionNode != nullptr && numberIntersections > 1){
+    if (minIntersectionNode != Network::NONE && numberIntersections >= minimumIntersections){
         startNode = minIntersectionNode;
         sortIntersectionsNetwork(unorderedIntersectionNodes);
 
+        if constexpr (PointPolicy::SEGMENT_POINTS){
+            addSegmentPointsToNetwork();
+        }
+
+        if constexpr (!PointPolicy::ANTI_CLOCKWISE){
+            calculateOrientation();
+        }
+
         LOG::NewLine(LogLevel::INFO);
 
     } else if (numberIntersections == 0){
         LOG(LogLevel::INFO) << "No intersections";
         startNode = firstNode;
-    } else if (numberIntersections == 1){
-        // sometimes it happens that there is only one intersection, specifically when the points and indices are manually entered
-        // this happens when the segment is tangent to the poligon, this case is handled as in the case when there are no intersections
+    } else if (numberIntersections < minimumIntersections){
         LOG(LogLevel::WARN) << "1 intersection";
         startNode = firstNode;
         numberIntersections = 0;
@@ -387,149 +365,844 @@ void Polygon::createNetworkMesh(std::vector<Vector2f>& extraPoint){
 }
 
 void Polygon::deleteStartNode(){
-    if (startNode){
-        Node::DeleteNetwork(startNode);
+    if (startNode != Network::NONE){
+        // every node of the network is in the network arrays
+        network->clear();
+        startNode = Network::NONE;
+        firstNode = Network::NONE;
     } else{
         LOG(LogLevel::DEBUG) << "Polygon was not cutted";
     }
     LOG(LogLevel::DEBUG) << "Polygon deleted";
 }
 
-std::vector<std::shared_ptr<std::vector<unsigned int>>> Polygon::cut(){
-    std::vector<std::shared_ptr<std::vector<unsigned int>>> polygonsIndices;
+// pieces policy of cut, cutIndices and cutReusing, all the small polygons go in the same set
+template<bool addSegmentPoints>
+struct Polygon::PlainPieces{
+    // a piece is the last polygon of the set it points to
+    using Piece = PolygonSet*;
+    static constexpr bool SEGMENT_POINTS = addSegmentPoints;
+
+    PolygonSet& polygonsIndices;
+
+    Piece create(unsigned int){
+        polygonsIndices.startPolygon();
+        return &polygonsIndices;
+    }
+
+    void close(Piece){}
+    void defer(Piece){}
+    void closeDeferred(){}
+};
+
+// pieces policy of cutInsideOutside, a small polygon is inside if it is on the left of the segment
+struct Polygon::InsideOutsidePieces{
+    using Piece = PolygonSet*;
+    static constexpr bool SEGMENT_POINTS = false;
+
+    const Polygon& polygon;
+    PolygonSet& insidePolygonsIndices;
+    PolygonSet& outsidePolygonsIndices;
+
+    Piece create(unsigned int node){
+        const Network& net = *polygon.network;
+        // the small polygon is just created and the relative position at the intersection node is parallel,
+        // we have to decide if the new small polygon is inside or outside from the next nodes
+        unsigned int tryNode = net.next[node];
+        RelativePosition relativePosition = RelativePosition::Parallel;
+        while (relativePosition == RelativePosition::Parallel && tryNode != node){
+            Intersector inter;
+            inter.setSegment1(polygon.p1, polygon.points[net.getIndex(tryNode)]);
+            inter.setSegment2(polygon.p2, polygon.points[net.getIndex(tryNode)]);
+            relativePosition = inter.calculateRelativePosition();
+            tryNode = net.next[tryNode];
+        }
+        if (relativePosition == RelativePosition::Positive){
+            insidePolygonsIndices.startPolygon();
+            return &insidePolygonsIndices;
+        }
+        if (relativePosition == RelativePosition::Negative){
+            outsidePolygonsIndices.startPolygon();
+            return &outsidePolygonsIndices;
+        }
+        LOG(LogLevel::ERROR) << "relative position is parallel every time";
+        return nullptr;
+    }
+
+    void close(Piece){}
+    void defer(Piece){}
+    void closeDeferred(){}
+};
+
+// pieces policy of cutInsideOutsideConcave, a small polygon is inside or outside the concave polygon
+// it can be decided only when all its points are there, so it is built in openPieces and moved when it is closed
+// a small polygon deferred is closed after all the ones created after it, so the one closed is always the last
+struct Polygon::ConcavePieces{
+    using Piece = PolygonSet*;
+    static constexpr bool SEGMENT_POINTS = false;
+
+    const Polygon& polygon;
+    PolygonSet& insidePolygonsIndices;
+    PolygonSet& outsidePolygonsIndices;
+    const PreparedPolygon& concavePolygon;
+    PolygonSet& openPieces;
+
+    Piece create(unsigned int){
+        openPieces.startPolygon();
+        return &openPieces;
+    }
+
+    void defer(Piece){}
+
+    void closeDeferred(){
+        close(&openPieces);
+    }
+
+    void close(Piece){
+        add(openPieces.back());
+        openPieces.removeLastPolygon();
+    }
+
+    void add(PolygonView indicesPoli){
+        // we decide if the polygon is inside or outside
+        bool allBoundary = false;
+        unsigned int correctIndex = 0;
+
+        unsigned int sizeIndicesPoli = indicesPoli.size();
+        for (unsigned int i = 0; i < sizeIndicesPoli; i++){
+            if (!concavePolygon.isPointBoundary(polygon.points[indicesPoli[i]])){
+                correctIndex = i;
+                break;
+            }
+            if (i == sizeIndicesPoli - 1){
+                allBoundary = true;
+            }
+        }
+
+        const Vector2r& point = polygon.points[indicesPoli[correctIndex]];
+        if (allBoundary){
+            LOG(LogLevel::INFO) << "Polygon::ConcavePieces: all points are boundary concave polygon";
+            insidePolygonsIndices.addPolygon(indicesPoli);
+        } else if (concavePolygon.isPointInside(point)){
+            insidePolygonsIndices.addPolygon(indicesPoli);
+        } else{
+            outsidePolygonsIndices.addPolygon(indicesPoli);
+        }
+    }
+};
+
+void Polygon::cutPlain(PolygonSet& polygonsIndices){
+    // the segment points are added while walking only if the network has them
+    if (alsoSegmentPoints){
+        PlainPieces<true> pieces{polygonsIndices};
+        cutSmallPolygons(startNode, pieces);
+    } else{
+        PlainPieces<false> pieces{polygonsIndices};
+        cutSmallPolygons(startNode, pieces);
+    }
+}
+
+PolygonSet Polygon::cut(){
+    PolygonSet polygonsIndices;
     if (numberIntersections > 0){
-        startNode->touched = true;
-        LOG(LogLevel::INFO) << startNode->getIndex() << " starting the cut";
-        polygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>());
-        std::vector<unsigned int>& indicesPoliCreation = *polygonsIndices[0];
-        continueSmallPolygon(startNode, startNode, indicesPoliCreation, polygonsIndices);
+        network->touched[startNode] = true;
+        LOG(LogLevel::INFO) << network->getIndex(startNode) << " starting the cut";
+        cutPlain(polygonsIndices);
     } else{
-        polygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+        polygonsIndices.addPolygon(indices);
     }
     return polygonsIndices;
 }
 
-void Polygon::cutIndices(std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices){
-    if (startNode && numberIntersections > 0){
-        startNode->touched = true;
-        LOG(LogLevel::INFO) << startNode->getIndex() << " starting the cut";
-        polygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>());
-        std::vector<unsigned int>& indicesPoliCreation = *polygonsIndices[polygonsIndices.size() - 1];
-        continueSmallPolygon(startNode, startNode, indicesPoliCreation, polygonsIndices);
+void Polygon::cutIndices(PolygonSet& polygonsIndices){
+    if (startNode != Network::NONE && numberIntersections > 0){
+        network->touched[startNode] = true;
+        LOG(LogLevel::INFO) << network->getIndex(startNode) << " starting the cut";
+        cutPlain(polygonsIndices);
     } else{
-        polygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+        polygonsIndices.addPolygon(indices);
     }
 }
 
-void Polygon::cutInsideOutside(std::vector<std::shared_ptr<std::vector<unsigned int>>>& insideIndices,
-                               std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsideIndices){
+void Polygon::cutReusing(PolygonSet& polygonsIndices){
+    // clear keeps the memory of the two arrays
+    polygonsIndices.clear();
+    cutIndices(polygonsIndices);
+}
+
+void Polygon::cutInsideOutside(PolygonSet& insideIndices,
+                               PolygonSet& outsideIndices){
     orientation = RelativePosition::Positive;
-    if (startNode && numberIntersections > 0){
-        if (!startNode || startNode == nullptr){
-            LOG(LogLevel::ERROR) << "Start node is nullptr and number of intersection is > 0";
+    if (startNode != Network::NONE && numberIntersections > 0){
+        if (startNode == Network::NONE){
+            LOG(LogLevel::ERROR) << "Start node is not linked and number of intersection is > 0";
             return;
         }
-        startNode->touched = true;
-        LOG(LogLevel::INFO) << startNode->getIndex() << " starting the cut";
-        continueSmallPolygonInsideOutside(startNode, startNode, nullptr, insideIndices, outsideIndices);
+        network->touched[startNode] = true;
+        LOG(LogLevel::INFO) << network->getIndex(startNode) << " starting the cut";
+        InsideOutsidePieces pieces{*this, insideIndices, outsideIndices};
+        cutSmallPolygons(startNode, pieces);
     } else{
-        if (!firstNode || firstNode == nullptr){
-            LOG(LogLevel::ERROR) << "first node is nullptr";
-            return;
-        }
-        Node* node = firstNode;
-        do{
+        // the network could not be created when the segment line is far from the polygon, so the indices are used
+        unsigned int numberIndices = getNumberIndices();
+        for (unsigned int i = 0; i < numberIndices; i++){
             Intersector inter;
-            inter.setSegment1(p1, points[node->getIndex()]);
-            inter.setSegment2(p2, points[node->getIndex()]);
+            inter.setSegment1(p1, points[indices[i]]);
+            inter.setSegment2(p2, points[indices[i]]);
             RelativePosition relativePosition = inter.calculateRelativePosition();
             if (relativePosition == RelativePosition::Positive){
-                insideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+                insideIndices.addPolygon(indices);
                 return;
             } else if (relativePosition == RelativePosition::Negative){
-                outsideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+                outsideIndices.addPolygon(indices);
                 return;
             }
-            node = node->next;
-        } while (node != firstNode);
+        }
         LOG(LogLevel::ERROR) << "relative position is parallel when no intersection";
     }
 }
 
-void Polygon::cutInsideOutsideConcave(std::vector<std::shared_ptr<std::vector<unsigned int>>>& insideIndices,
-                                      std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsideIndices,
-                                      const std::vector<Vector2f>& concaveVertices, const std::vector<unsigned int>& concaveIndices,
+void Polygon::cutInsideOutsideConcave(PolygonSet& insideIndices,
+                                      PolygonSet& outsideIndices,
+                                      const std::vector<Vector2r>& concaveVertices, const std::vector<Index>& concaveIndices,
                                       RelativePosition relativePosition){
+    const PreparedPolygon concavePolygon(concaveVertices, concaveIndices);
+    cutInsideOutsideConcave(insideIndices, outsideIndices, concavePolygon, relativePosition);
+}
+
+void Polygon::cutInsideOutsideConcave(PolygonSet& insideIndices,
+                                      PolygonSet& outsideIndices,
+                                      const PreparedPolygon& concavePolygon, RelativePosition relativePosition){
     orientation = RelativePosition::Positive;
-    if (startNode && numberIntersections > 0){
-        if (!startNode || startNode == nullptr){
-            LOG(LogLevel::ERROR) << "Start node is nullptr and number of intersection is > 0";
+    if (startNode != Network::NONE && numberIntersections > 0){
+        if (startNode == Network::NONE){
+            LOG(LogLevel::ERROR) << "Start node is not linked and number of intersection is > 0";
             return;
         }
-        startNode->touched = true;
-        LOG(LogLevel::INFO) << startNode->getIndex() << " starting the cut";
-        continueSmallPolygonInsideOutsideConcave(startNode, startNode, nullptr,
-                                                 insideIndices, outsideIndices, concaveVertices, concaveIndices);
+        network->touched[startNode] = true;
+        LOG(LogLevel::INFO) << network->getIndex(startNode) << " starting the cut";
+        workspace.openPieces.clear();
+        ConcavePieces pieces{*this, insideIndices, outsideIndices, concavePolygon, workspace.openPieces};
+        cutSmallPolygons(startNode, pieces);
     } else{
-        if (!firstNode || firstNode == nullptr){
-            LOG(LogLevel::ERROR) << "first node is nullptr";
-            return;
-        }
-
         if (relativePosition == RelativePosition::Positive){
-            insideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+            insideIndices.addPolygon(indices);
         } else if (relativePosition == RelativePosition::Negative){
-            outsideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+            outsideIndices.addPolygon(indices);
         } else{
-            bool allBoundary = false;
-            unsigned int correctIndex = 0;
-
-            const std::vector<unsigned int>& indicesPoli = indices;
-            unsigned int sizeIndicesPoli = indicesPoli.size();
-            for (unsigned int i = 0; i < sizeIndicesPoli; i++){
-                if (!isPointBoundaryConcavePolygon(points[indicesPoli[i]], concaveVertices, concaveIndices)){
-                    correctIndex = i;
-                    break;
+            // the polygon is classified as a small polygon just closed
+            ConcavePieces pieces{*this, insideIndices, outsideIndices, concavePolygon, workspace.openPieces};
+            pieces.add(indices);
+        }
+    }
+}
+
+void Polygon::cutArrangement(const std::vector<Segment>& lines, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                             PolygonSet& piecesIndices,
+                             std::vector<std::vector<RelativePosition>>& signatures, bool fixedPoint){
+    if (extraPoint.size() != points.size()){
+        LOG(LogLevel::WARN) << "points and extra points do not have the same size";
+    }
+    if (grid.getNumberPoints() != points.size()){
+        LOG(LogLevel::WARN) << "grid does not index the points of the polygon, it is built again";
+        grid.build(points);
+    }
+    const unsigned int numberIndices = getNumberIndices();
+    const unsigned int numberLines = lines.size();
+    if (numberIndices < 3){
+        LOG(LogLevel::ERROR) << "polygon with less than 3 indices can not be cutted";
+        return;
+    }
+
+    // the boundary is walked anti-clockwise so the pieces are always on the left of its edges
+    std::vector<Index> boundary;
+    Real boxXMin, boxYMin, boxXMax, boxYMax;
+    calculateBoundaryAntiClockwise(boundary, boxXMin, boxYMin, boxXMax, boxYMax);
+
+    // a line away from the box leaves the whole polygon on one of its sides, only the others cut it
+    std::vector<unsigned int> cuttingLines;
+    std::vector<RelativePosition> awaySides(numberLines, RelativePosition::Parallel);
+    for (unsigned int j = 0; j < numberLines; j++){
+        const Vector2r s1 = lines[j].getS1();
+        const Vector2r s2 = lines[j].getS2();
+        if (s1.x == s2.x && s1.y == s2.y){
+            LOG(LogLevel::WARN) << "line " << j << " has two equal points, it does not cut";
+        } else if (EdgeTree::IsLineAwayFromBox(s1, s2, boxXMin, boxYMin, boxXMax, boxYMax)){
+            awaySides[j] = Predicates::CalculateRelativePosition(s1, s2, s1, Vector2r(boxXMin, boxYMin));
+        } else{
+            cuttingLines.push_back(j);
+        }
+    }
+    const unsigned int numberCutting = cuttingLines.size();
+
+    // every point on a line is kept with its position along the line, to sort them after
+    std::vector<std::vector<std::pair<double, unsigned int>>> linePoints(numberCutting);
+    auto positionOnLine = [&lines, &cuttingLines](unsigned int c, const Vector2r& point){
+        const Vector2r s1 = lines[cuttingLines[c]].getS1();
+        const Vector2r s2 = lines[cuttingLines[c]].getS2();
+        return ((double)s2.x - s1.x) * ((double)point.x - s1.x) + ((double)s2.y - s1.y) * ((double)point.y - s1.y);
+    };
+    auto distanceFromLine = [&lines, &cuttingLines](unsigned int c, const Vector2r& point){
+        const Vector2r s1 = lines[cuttingLines[c]].getS1();
+        const Vector2r s2 = lines[cuttingLines[c]].getS2();
+        return ((double)s2.x - s1.x) * ((double)point.y - s1.y) - ((double)s2.y - s1.y) * ((double)point.x - s1.x);
+    };
+
+    // sides of the boundary vertices are exact, so an edge is crossed only if its vertices are on different sides
+    // sides[c * numberIndices + i] is the side of boundary vertex i with respect to cutting line c
+    std::vector<RelativePosition> sides(numberCutting * numberIndices);
+    for (unsigned int c = 0; c < numberCutting; c++){
+        const Vector2r s1 = lines[cuttingLines[c]].getS1();
+        const Vector2r s2 = lines[cuttingLines[c]].getS2();
+        for (unsigned int i = 0; i < numberIndices; i++){
+            const Vector2r& point = points[boundary[i]];
+            sides[c * numberIndices + i] = Predicates::CalculateRelativePosition(s1, s2, s1, point);
+            if (sides[c * numberIndices + i] == RelativePosition::Parallel){
+                linePoints[c].push_back({positionOnLine(c, point), boundary[i]});
+            }
+        }
+    }
+
+    // the boundary edges are split where the lines cross them, the crossing points go also on their lines
+    std::vector<Index> boundaryChain;
+    std::vector<std::pair<double, unsigned int>> edgeCrossings;
+    for (unsigned int i = 0; i < numberIndices; i++){
+        const unsigned int next = (i + 1) % numberIndices;
+        // points can grow, so the vertices are copied
+        const Vector2r first = points[boundary[i]];
+        const Vector2r second = points[boundary[next]];
+        if (boundaryChain.empty() || boundaryChain.back() != boundary[i]){
+            boundaryChain.push_back(boundary[i]);
+        }
+
+        edgeCrossings.clear();
+        for (unsigned int c = 0; c < numberCutting; c++){
+            const RelativePosition sideFirst = sides[c * numberIndices + i];
+            const RelativePosition sideSecond = sides[c * numberIndices + next];
+            if (sideFirst != RelativePosition::Parallel && sideSecond != RelativePosition::Parallel && sideFirst != sideSecond){
+                // the distance from the line goes linearly to zero along the edge
+                const double distanceFirst = distanceFromLine(c, first);
+                const double distanceSecond = distanceFromLine(c, second);
+                edgeCrossings.push_back({distanceFirst / (distanceFirst - distanceSecond), c});
+            }
+        }
+        std::sort(edgeCrossings.begin(), edgeCrossings.end());
+
+        for (const std::pair<double, unsigned int>& crossing : edgeCrossings){
+            const double t = crossing.first;
+            Vector2r crossingPoint(first.x + t * ((double)second.x - first.x), first.y + t * ((double)second.y - first.y));
+            if (fixedPoint){
+                crossingPoint = FixedPoint::SnapCrossing(first, second, lines[cuttingLines[crossing.second]].getS1(),
+                                                         lines[cuttingLines[crossing.second]].getS2());
+            }
+            const unsigned int index = findOrAddPoint(crossingPoint, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+            linePoints[crossing.second].push_back({positionOnLine(crossing.second, crossingPoint), index});
+            if (boundaryChain.back() != index){
+                boundaryChain.push_back(index);
+            }
+        }
+    }
+    while (boundaryChain.size() > 1 && boundaryChain.back() == boundaryChain.front()){
+        boundaryChain.pop_back();
+    }
+
+    // where two lines meet inside the polygon both of them are split, the crossing points are found first
+    // so a meeting point on the boundary becomes the same point as the crossing
+    const Real margin = sqrt(Vector2r::TOLERANCE);
+    for (unsigned int c = 0; c < numberCutting; c++){
+        const Vector2r r1 = lines[cuttingLines[c]].getS1();
+        const Vector2r r2 = lines[cuttingLines[c]].getS2();
+        for (unsigned int d = c + 1; d < numberCutting; d++){
+            const Vector2r s1 = lines[cuttingLines[d]].getS1();
+            const Vector2r s2 = lines[cuttingLines[d]].getS2();
+            if (Predicates::Cross(r1, r2, s1, s2) == 0){
+                continue;
+            }
+            const double rX = (double)r2.x - r1.x;
+            const double rY = (double)r2.y - r1.y;
+            const double sX = (double)s2.x - s1.x;
+            const double sY = (double)s2.y - s1.y;
+            const double t = (((double)s1.x - r1.x) * sY - ((double)s1.y - r1.y) * sX) / (rX * sY - rY * sX);
+            Vector2r meetingPoint(r1.x + t * rX, r1.y + t * rY);
+            if (fixedPoint){
+                meetingPoint = FixedPoint::SnapMeeting(r1, r2, s1, s2);
+            }
+            if (meetingPoint.x < boxXMin - margin || meetingPoint.x > boxXMax + margin ||
+                meetingPoint.y < boxYMin - margin || meetingPoint.y > boxYMax + margin){
+                continue;
+            }
+            const unsigned int index = findOrAddPoint(meetingPoint, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+            linePoints[c].push_back({positionOnLine(c, meetingPoint), index});
+            linePoints[d].push_back({positionOnLine(d, meetingPoint), index});
+        }
+    }
+
+    // every part of a line between two of its points is a chord if it is inside the polygon
+    // the parts on the boundary are already boundary edges
+    std::vector<std::pair<unsigned int, unsigned int>> boundaryEdges;
+    const unsigned int numberChain = boundaryChain.size();
+    for (unsigned int i = 0; i < numberChain; i++){
+        const unsigned int first = boundaryChain[i];
+        const unsigned int second = boundaryChain[(i + 1) % numberChain];
+        boundaryEdges.push_back({std::min(first, second), std::max(first, second)});
+    }
+    std::sort(boundaryEdges.begin(), boundaryEdges.end());
+
+    std::vector<std::pair<unsigned int, unsigned int>> chords;
+    for (unsigned int c = 0; c < numberCutting; c++){
+        std::vector<std::pair<double, unsigned int>>& onLine = linePoints[c];
+        std::sort(onLine.begin(), onLine.end());
+        const unsigned int numberOnLine = onLine.size();
+        for (unsigned int k = 1; k < numberOnLine; k++){
+            const unsigned int first = onLine[k - 1].second;
+            const unsigned int second = onLine[k].second;
+            if (first == second){
+                continue;
+            }
+            const std::pair<unsigned int, unsigned int> edge(std::min(first, second), std::max(first, second));
+            if (std::binary_search(boundaryEdges.begin(), boundaryEdges.end(), edge)){
+                continue;
+            }
+            const Vector2r middle((points[first].x + points[second].x) / 2.0f, (points[first].y + points[second].y) / 2.0f);
+            if (Polygon::IsPointInsideSimplePolygon(middle, points, boundary)){
+                chords.push_back({first, second});
+            }
+        }
+    }
+
+    // the pieces are traced directly at the end of piecesIndices
+    const unsigned int firstPiece = piecesIndices.size();
+    Polygon::TraceFaces(points, boundaryChain, chords, piecesIndices);
+    const unsigned int numberPieces = piecesIndices.size() - firstPiece;
+
+    // a piece is all on one side of every line, the vertex farthest from the line tells which one
+    for (unsigned int k = firstPiece; k < piecesIndices.size(); k++){
+        const PolygonView piece = piecesIndices[k];
+        std::vector<RelativePosition> signature(awaySides);
+        for (unsigned int c = 0; c < numberCutting; c++){
+            double farthest = 0.0;
+            for (unsigned int index : piece){
+                const double distance = distanceFromLine(c, points[index]);
+                if (fabs(distance) > fabs(farthest)){
+                    farthest = distance;
                 }
-                if (i == sizeIndicesPoli - 1){
-                    allBoundary = true;
+            }
+            if (farthest > 0.0){
+                signature[cuttingLines[c]] = RelativePosition::Positive;
+            } else if (farthest < 0.0){
+                signature[cuttingLines[c]] = RelativePosition::Negative;
+            }
+        }
+        signatures.push_back(std::move(signature));
+    }
+    LOG(LogLevel::INFO) << "arrangement of " << numberCutting << " lines, " << numberPieces << " pieces";
+}
+
+void Polygon::clipInsideOutside(const PreparedPolygon& clipPolygon, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                                PolygonSet& insideIndices,
+                                PolygonSet& outsideIndices, bool fixedPoint){
+    if (extraPoint.size() != points.size()){
+        LOG(LogLevel::WARN) << "points and extra points do not have the same size";
+    }
+    if (grid.getNumberPoints() != points.size()){
+        LOG(LogLevel::WARN) << "grid does not index the points of the polygon, it is built again";
+        grid.build(points);
+    }
+    const unsigned int numberIndices = getNumberIndices();
+    if (numberIndices < 3){
+        LOG(LogLevel::ERROR) << "polygon with less than 3 indices can not be clipped";
+        return;
+    }
+
+    std::vector<Index> boundary;
+    Real boxXMin, boxYMin, boxXMax, boxYMax;
+    calculateBoundaryAntiClockwise(boundary, boxXMin, boxYMin, boxXMax, boxYMax);
+
+    // only the clip edges near the box can meet the boundary or be inside it
+    const std::vector<Vector2r>& clipVertices = clipPolygon.getVertices();
+    const std::vector<Index>& clipIndices = clipPolygon.getIndices();
+    const unsigned int numberClipIndices = clipIndices.size();
+    std::vector<unsigned int> clipEdges;
+    clipPolygon.getBoxEdges(boxXMin, boxYMin, boxXMax, boxYMax, clipEdges);
+    const unsigned int numberClipEdges = clipEdges.size();
+
+    // every point on a clip edge is kept with its position along the edge, the two ends of the edge are not
+    // in points until a part of the edge is used, their index is Network::NONE
+    struct EdgePoint{
+        double position;
+        unsigned int index;
+        Vector2r point;
+    };
+    std::vector<std::vector<EdgePoint>> clipEdgePoints(numberClipEdges);
+    auto positionOnSegment = [](const Vector2r& s1, const Vector2r& s2, const Vector2r& point){
+        return ((double)s2.x - s1.x) * ((double)point.x - s1.x) + ((double)s2.y - s1.y) * ((double)point.y - s1.y);
+    };
+    // for a point on the line of the segment
+    auto isInsideSegment = [&positionOnSegment](const Vector2r& s1, const Vector2r& s2, const Vector2r& point){
+        return positionOnSegment(s1, s2, point) > 0.0 && positionOnSegment(s2, s1, point) > 0.0;
+    };
+
+    // both boundaries are walked once, where they meet the point is added to both of them
+    // it has the same index in the two, as the up and down nodes of a network link the polygon to the segment
+    std::vector<Index> boundaryChain;
+    std::vector<std::pair<double, unsigned int>> edgeCrossings;
+    for (unsigned int i = 0; i < numberIndices; i++){
+        const unsigned int next = (i + 1) % numberIndices;
+        // points can grow, so the vertices are copied
+        const Vector2r first = points[boundary[i]];
+        const Vector2r second = points[boundary[next]];
+        if (boundaryChain.empty() || boundaryChain.back() != boundary[i]){
+            boundaryChain.push_back(boundary[i]);
+        }
+
+        edgeCrossings.clear();
+        for (unsigned int k = 0; k < numberClipEdges; k++){
+            const Vector2r& s1 = clipVertices[clipIndices[clipEdges[k]]];
+            const Vector2r& s2 = clipVertices[clipIndices[(clipEdges[k] + 1) % numberClipIndices]];
+            if (std::max(s1.x, s2.x) < std::min(first.x, second.x) || std::min(s1.x, s2.x) > std::max(first.x, second.x) ||
+                std::max(s1.y, s2.y) < std::min(first.y, second.y) || std::min(s1.y, s2.y) > std::max(first.y, second.y)){
+                continue;
+            }
+            const int sideFirst = Predicates::Orient2d(s1, s2, first);
+            const int sideSecond = Predicates::Orient2d(s1, s2, second);
+            const int sideS1 = Predicates::Orient2d(first, second, s1);
+            const int sideS2 = Predicates::Orient2d(first, second, s2);
+            if (sideFirst * sideSecond < 0 && sideS1 * sideS2 < 0){
+                // the distance from the clip edge goes linearly to zero along the edge
+                const double distanceFirst = ((double)s2.x - s1.x) * ((double)first.y - s1.y) - ((double)s2.y - s1.y) * ((double)first.x - s1.x);
+                const double distanceSecond = ((double)s2.x - s1.x) * ((double)second.y - s1.y) - ((double)s2.y - s1.y) * ((double)second.x - s1.x);
+                const double t = distanceFirst / (distanceFirst - distanceSecond);
+                Vector2r crossingPoint(first.x + t * ((double)second.x - first.x), first.y + t * ((double)second.y - first.y));
+                if (fixedPoint){
+                    crossingPoint = FixedPoint::SnapCrossing(first, second, s1, s2);
                 }
+                const unsigned int index = findOrAddPoint(crossingPoint, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+                edgeCrossings.push_back({t, index});
+                clipEdgePoints[k].push_back({positionOnSegment(s1, s2, crossingPoint), index, crossingPoint});
+                continue;
+            }
+            // a vertex that is exactly on the other edge splits it, the ones at the ends are already there
+            if (sideFirst == 0 && isInsideSegment(s1, s2, first)){
+                clipEdgePoints[k].push_back({positionOnSegment(s1, s2, first), boundary[i], first});
+            }
+            if (sideS1 == 0 && isInsideSegment(first, second, s1)){
+                const unsigned int index = findOrAddPoint(s1, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+                edgeCrossings.push_back({positionOnSegment(first, second, s1) / positionOnSegment(first, second, second), index});
+            }
+        }
+        std::sort(edgeCrossings.begin(), edgeCrossings.end());
+        for (const std::pair<double, unsigned int>& crossing : edgeCrossings){
+            if (boundaryChain.back() != crossing.second){
+                boundaryChain.push_back(crossing.second);
             }
+        }
+    }
+    while (boundaryChain.size() > 1 && boundaryChain.back() == boundaryChain.front()){
+        boundaryChain.pop_back();
+    }
+
+    std::vector<std::pair<unsigned int, unsigned int>> boundaryEdges;
+    const unsigned int numberChain = boundaryChain.size();
+    for (unsigned int i = 0; i < numberChain; i++){
+        const unsigned int first = boundaryChain[i];
+        const unsigned int second = boundaryChain[(i + 1) % numberChain];
+        boundaryEdges.push_back({std::min(first, second), std::max(first, second)});
+    }
+    std::sort(boundaryEdges.begin(), boundaryEdges.end());
+
+    // every part of a clip edge between two of its points is a chord if it is inside the boundary,
+    // the parts on the boundary are already boundary edges
+    // both are kept in clipHalfEdges in the direction that has the inside of the clip polygon on the left
+    const bool clipAntiClockwise = clipPolygon.isCounterclockwise();
+    std::vector<std::pair<unsigned int, unsigned int>> chords;
+    std::unordered_set<uint64_t> clipHalfEdges;
+    auto addClipHalfEdge = [&clipHalfEdges, clipAntiClockwise](unsigned int first, unsigned int second){
+        if (clipAntiClockwise){
+            clipHalfEdges.insert(((uint64_t)first << 32) | second);
+        } else{
+            clipHalfEdges.insert(((uint64_t)second << 32) | first);
+        }
+    };
+    for (unsigned int k = 0; k < numberClipEdges; k++){
+        const Vector2r& s1 = clipVertices[clipIndices[clipEdges[k]]];
+        const Vector2r& s2 = clipVertices[clipIndices[(clipEdges[k] + 1) % numberClipIndices]];
+        if (std::max(s1.x, s2.x) < boxXMin || std::min(s1.x, s2.x) > boxXMax ||
+            std::max(s1.y, s2.y) < boxYMin || std::min(s1.y, s2.y) > boxYMax || (s1.x == s2.x && s1.y == s2.y)){
+            continue;
+        }
+        std::vector<EdgePoint>& onEdge = clipEdgePoints[k];
+        onEdge.push_back({0.0, Network::NONE, s1});
+        onEdge.push_back({positionOnSegment(s1, s2, s2), Network::NONE, s2});
+        std::sort(onEdge.begin(), onEdge.end(), [](const EdgePoint& a, const EdgePoint& b){
+            return a.position < b.position;
+        });
+
+        const unsigned int numberOnEdge = onEdge.size();
+        for (unsigned int j = 1; j < numberOnEdge; j++){
+            EdgePoint& first = onEdge[j - 1];
+            EdgePoint& second = onEdge[j];
+            // an end that is already a point of the boundary can be on it
+            unsigned int firstIndex = first.index;
+            unsigned int secondIndex = second.index;
+            if (firstIndex == Network::NONE && !grid.find(first.point, points, firstIndex, Polygon::TOLERANCE_ARRANGEMENT)){
+                firstIndex = Network::NONE;
+            }
+            if (secondIndex == Network::NONE && !grid.find(second.point, points, secondIndex, Polygon::TOLERANCE_ARRANGEMENT)){
+                secondIndex = Network::NONE;
+            }
+            if (firstIndex != Network::NONE && firstIndex == secondIndex){
+                continue;
+            }
+            if (firstIndex != Network::NONE && secondIndex != Network::NONE &&
+                std::binary_search(boundaryEdges.begin(), boundaryEdges.end(),
+                                   std::make_pair(std::min(firstIndex, secondIndex), std::max(firstIndex, secondIndex)))){
+                addClipHalfEdge(firstIndex, secondIndex);
+                continue;
+            }
+            const Vector2r middle((first.point.x + second.point.x) / 2.0f, (first.point.y + second.point.y) / 2.0f);
+            if (Polygon::IsPointInsideSimplePolygon(middle, points, boundary)){
+                first.index = findOrAddPoint(first.point, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+                second.index = findOrAddPoint(second.point, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+                if (first.index != second.index){
+                    chords.push_back({first.index, second.index});
+                    addClipHalfEdge(first.index, second.index);
+                }
+            }
+        }
+    }
+
+    // the clip boundary can touch a piece without clip edges only in its vertices (they are added to both boundaries)
+    // so the middle of one of its edges is not on the clip boundary and it is inside if the piece is
+    auto isPieceInside = [this, &clipPolygon](PolygonView piece){
+        const Vector2r& first = points[piece[0]];
+        const Vector2r& second = points[piece[1]];
+        return clipPolygon.isPointInsideExact(Vector2r((first.x + second.x) / 2.0f, (first.y + second.y) / 2.0f));
+    };
+
+    if (clipHalfEdges.empty()){
+        if (isPieceInside(boundaryChain)){
+            insideIndices.addPolygon(boundaryChain);
+        } else{
+            outsideIndices.addPolygon(boundaryChain);
+        }
+        return;
+    }
+
+    // a piece is on the left of its edges, so it is inside if it goes along a clip edge in the direction of clipHalfEdges
+    PolygonSet pieces;
+    Polygon::TraceFaces(points, boundaryChain, chords, pieces);
+    for (const PolygonView piece : pieces){
+        const unsigned int numberPiece = piece.size();
+        bool found = false;
+        bool inside = false;
+        for (unsigned int j = 0; j < numberPiece && !found; j++){
+            const uint64_t first = piece[j];
+            const uint64_t second = piece[(j + 1) % numberPiece];
+            if (clipHalfEdges.count((first << 32) | second) > 0){
+                found = true;
+                inside = true;
+            } else if (clipHalfEdges.count((second << 32) | first) > 0){
+                found = true;
+            }
+        }
+        if (!found){
+            inside = isPieceInside(piece);
+        }
+        if (inside){
+            insideIndices.addPolygon(piece);
+        } else{
+            outsideIndices.addPolygon(piece);
+        }
+    }
+    LOG(LogLevel::INFO) << "clip with " << numberClipEdges << " edges, " << pieces.size() << " pieces";
+}
 
-            const Vector2f& point = points[indicesPoli[correctIndex]];
-            if (allBoundary){
-                LOG(LogLevel::INFO) << "Polygon::continueSmallPolygonInsideOutsideConcave: all points are boundary concave polygon";
-                insideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
-            } else if (isPointInsideConcavePolygon(point, concaveVertices, concaveIndices)){
-                insideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+void Polygon::cutConvexBorder(const std::vector<Segment>& borderLines, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                              PolygonSet& insideIndices,
+                              PolygonSet& outsideIndices, bool fixedPoint){
+    const unsigned int numberIndices = getNumberIndices();
+    if (numberIndices < 3){
+        LOG(LogLevel::ERROR) << "polygon with less than 3 indices can not be cutted";
+        return;
+    }
+    if (!Polygon::IsConvex(points, indices)){
+        PolygonSet pieces;
+        std::vector<std::vector<RelativePosition>> signatures;
+        cutArrangement(borderLines, extraPoint, grid, pieces, signatures, fixedPoint);
+        const unsigned int numberPieces = pieces.size();
+        for (unsigned int k = 0; k < numberPieces; k++){
+            const bool inside = std::all_of(signatures[k].begin(), signatures[k].end(), [](RelativePosition side){
+                return side == RelativePosition::Positive;
+            });
+            if (inside){
+                insideIndices.addPolygon(pieces[k]);
             } else{
-                outsideIndices.push_back(std::make_shared<std::vector<unsigned int>>(indices));
+                outsideIndices.addPolygon(pieces[k]);
+            }
+        }
+        return;
+    }
+    if (extraPoint.size() != points.size()){
+        LOG(LogLevel::WARN) << "points and extra points do not have the same size";
+    }
+    if (grid.getNumberPoints() != points.size()){
+        LOG(LogLevel::WARN) << "grid does not index the points of the polygon, it is built again";
+        grid.build(points);
+    }
+
+    std::vector<Index> boundary;
+    Real boxXMin, boxYMin, boxXMax, boxYMax;
+    calculateBoundaryAntiClockwise(boundary, boxXMin, boxYMin, boxXMax, boxYMax);
+
+    // piece k has the indices from pieceStart[k] to pieceStart[k + 1] of pieceIndices, it is inside if it is
+    // on the left of all the lines done, every line makes the next pieces from the current ones
+    std::vector<Index> pieceIndices(boundary);
+    std::vector<unsigned int> pieceStart{0, numberIndices};
+    std::vector<bool> pieceInside{true};
+    std::vector<Index> nextIndices;
+    std::vector<unsigned int> nextStart;
+    std::vector<bool> nextInside;
+    std::vector<Index> rightIndices;
+    std::vector<Real> x;
+    std::vector<Real> y;
+    std::vector<double> distances;
+    std::vector<int> sides;
+
+    // a piece is added without the same index twice in a row, it is dropped if it has no area left
+    auto addPiece = [this, &nextIndices, &nextStart, &nextInside](unsigned int first, bool inside){
+        unsigned int last = nextIndices.size();
+        while (last - first > 1 && nextIndices[last - 1] == nextIndices[first]){
+            last--;
+        }
+        nextIndices.resize(last);
+        double doubleArea = 0.0;
+        for (unsigned int i = first; i < last; i++){
+            const Vector2r& current = points[nextIndices[i]];
+            const Vector2r& next = points[nextIndices[i + 1 < last ? i + 1 : first]];
+            doubleArea += (double)current.x * next.y - (double)next.x * current.y;
+        }
+        if (last - first < 3 || !(doubleArea > 0.0)){
+            nextIndices.resize(first);
+            return;
+        }
+        nextStart.push_back(last);
+        nextInside.push_back(inside);
+    };
+    auto pushIndex = [](std::vector<Index>& buffer, unsigned int first, Index index){
+        if (buffer.size() == first || buffer.back() != index){
+            buffer.push_back(index);
+        }
+    };
+
+    unsigned int numberCutting = 0;
+    for (const Segment& line : borderLines){
+        const Vector2r s1 = line.getS1();
+        const Vector2r s2 = line.getS2();
+        if (s1.x == s2.x && s1.y == s2.y){
+            LOG(LogLevel::WARN) << "line has two equal points, it does not cut";
+            continue;
+        }
+        // a line away from the box leaves all the pieces on one of its sides
+        if (EdgeTree::IsLineAwayFromBox(s1, s2, boxXMin, boxYMin, boxXMax, boxYMax)){
+            if (Predicates::Orient2d(s1, s2, Vector2r(boxXMin, boxYMin)) < 0){
+                pieceInside.assign(pieceInside.size(), false);
             }
+            continue;
         }
+        numberCutting++;
+
+        nextIndices.clear();
+        nextStart.assign(1, 0);
+        nextInside.clear();
+        const unsigned int numberPieces = pieceInside.size();
+        for (unsigned int k = 0; k < numberPieces; k++){
+            const unsigned int start = pieceStart[k];
+            const unsigned int size = pieceStart[k + 1] - start;
+            x.resize(size);
+            y.resize(size);
+            for (unsigned int v = 0; v < size; v++){
+                x[v] = points[pieceIndices[start + v]].x;
+                y[v] = points[pieceIndices[start + v]].y;
+            }
+            Intersector::CalculateSides(s1, s2, x, y, distances, sides);
+            const bool anyLeft = std::find(sides.begin(), sides.end(), 1) != sides.end();
+            const bool anyRight = std::find(sides.begin(), sides.end(), -1) != sides.end();
+            if (!anyLeft || !anyRight){
+                nextIndices.insert(nextIndices.end(), pieceIndices.begin() + start, pieceIndices.begin() + start + size);
+                nextStart.push_back(nextIndices.size());
+                nextInside.push_back(pieceInside[k] && anyLeft);
+                continue;
+            }
+
+            // the piece is convex, the line crosses it in two edges: the part on the left is written directly
+            // after the next pieces, the one on the right is kept aside and written after it
+            const unsigned int first = nextIndices.size();
+            rightIndices.clear();
+            for (unsigned int v = 0; v < size; v++){
+                const unsigned int w = (v + 1) % size;
+                const unsigned int index = pieceIndices[start + v];
+                if (sides[v] >= 0){
+                    pushIndex(nextIndices, first, index);
+                }
+                if (sides[v] <= 0){
+                    pushIndex(rightIndices, 0, index);
+                }
+                if (sides[v] * sides[w] < 0){
+                    // the distance from the line goes linearly to zero along the edge
+                    const double t = distances[v] / (distances[v] - distances[w]);
+                    Vector2r crossingPoint(x[v] + t * ((double)x[w] - x[v]), y[v] + t * ((double)y[w] - y[v]));
+                    if (fixedPoint){
+                        crossingPoint = FixedPoint::SnapCrossing(Vector2r(x[v], y[v]), Vector2r(x[w], y[w]), s1, s2);
+                    }
+                    const unsigned int crossing = findOrAddPoint(crossingPoint, extraPoint, grid, Polygon::TOLERANCE_ARRANGEMENT);
+                    pushIndex(nextIndices, first, crossing);
+                    pushIndex(rightIndices, 0, crossing);
+                }
+            }
+            addPiece(first, pieceInside[k]);
+            const unsigned int firstRight = nextIndices.size();
+            nextIndices.insert(nextIndices.end(), rightIndices.begin(), rightIndices.end());
+            addPiece(firstRight, false);
+        }
+        pieceIndices.swap(nextIndices);
+        pieceStart.swap(nextStart);
+        pieceInside.swap(nextInside);
     }
+
+    const unsigned int numberPieces = pieceInside.size();
+    for (unsigned int k = 0; k < numberPieces; k++){
+        const PolygonView piece(pieceIndices.data() + pieceStart[k], pieceStart[k + 1] - pieceStart[k]);
+        if (pieceInside[k]){
+            insideIndices.addPolygon(piece);
+        } else{
+            outsideIndices.addPolygon(piece);
+        }
+    }
+    LOG(LogLevel::INFO) << "convex cut by " << numberCutting << " lines, " << numberPieces << " pieces";
 }
 
-float Polygon::getWidth() const{
+Real Polygon::getWidth() const{
     return width;
 }
 
-float Polygon::getHeight() const{
+Real Polygon::getHeight() const{
     return height;
 }
 
-float Polygon::getXMin() const{
+Real Polygon::getXMin() const{
     return xMin;
 }
 
-float Polygon::getYMin() const{
+Real Polygon::getYMin() const{
     return yMin;
 }
 
 // STATIC
 
 const double Polygon::BIG_DOUBLE = 1.0E+10;
+const double Polygon::TOLERANCE_ARRANGEMENT = 1.0E-12;
 
-double Polygon::CalculateArea(const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices){
+double Polygon::CalculateArea(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
     double sum = 0;
 
     unsigned int sizeIndices = indices.size();
@@ -540,7 +1213,7 @@ double Polygon::CalculateArea(const std::vector<Vector2f>& vertices, const std::
     return abs(sum) / 2;
 }
 
-double Polygon::CalculateArea(const std::vector<Vector2f>& vertices){
+double Polygon::CalculateArea(const std::vector<Vector2r>& vertices){
     double sum = 0;
 
     unsigned int sizeVertices = vertices.size();
@@ -551,35 +1224,93 @@ double Polygon::CalculateArea(const std::vector<Vector2f>& vertices){
     return abs(sum) / 2;
 }
 
-std::vector<Vector2f> Polygon::translateVertices(const std::vector<Vector2f>& vertices, float diff_x, float diff_y)
+bool Polygon::IsConvex(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
+    const unsigned int numberIndices = indices.size();
+    if (numberIndices < 3){
+        return false;
+    }
+    // the turns are exact, a polygon that goes around more than once (as a star) turns always on the same side
+    // too, but its edges change direction on an axis more than twice
+    int turn = 0;
+    unsigned int changesX = 0;
+    unsigned int changesY = 0;
+    int firstDirectionX = 0;
+    int firstDirectionY = 0;
+    int directionX = 0;
+    int directionY = 0;
+    for (unsigned int i = 0; i < numberIndices; i++){
+        const Vector2r& first = vertices[indices[i]];
+        const Vector2r& second = vertices[indices[(i + 1) % numberIndices]];
+        const Vector2r& third = vertices[indices[(i + 2) % numberIndices]];
+        const int side = Predicates::Orient2d(first, second, third);
+        if (side != 0){
+            if (turn != 0 && side != turn){
+                return false;
+            }
+            turn = side;
+        }
+        const int edgeX = (second.x > first.x) - (second.x < first.x);
+        const int edgeY = (second.y > first.y) - (second.y < first.y);
+        if (edgeX != 0){
+            if (directionX == 0){
+                firstDirectionX = edgeX;
+            } else if (edgeX != directionX){
+                changesX++;
+            }
+            directionX = edgeX;
+        }
+        if (edgeY != 0){
+            if (directionY == 0){
+                firstDirectionY = edgeY;
+            } else if (edgeY != directionY){
+                changesY++;
+            }
+            directionY = edgeY;
+        }
+    }
+    // going back to the first edge
+    changesX += directionX != firstDirectionX;
+    changesY += directionY != firstDirectionY;
+    return turn != 0 && changesX <= 2 && changesY <= 2;
+}
+
+bool Polygon::IsConvex(const std::vector<Vector2r>& vertices){
+    std::vector<Index> indices;
+    for (unsigned int i = 0; i < vertices.size(); i++){
+        indices.push_back(i);
+    }
+    return Polygon::IsConvex(vertices, indices);
+}
+
+std::vector<Vector2r> Polygon::translateVertices(const std::vector<Vector2r>& vertices, Real diff_x, Real diff_y)
 {
     unsigned int sizeVertices = vertices.size();
-    std::vector<Vector2f> translated;
+    std::vector<Vector2r> translated;
 
     for (unsigned int i = 0; i < sizeVertices; i++){
-        translated.push_back(vertices[i] + Vector2f(diff_x, diff_y));
+        translated.push_back(vertices[i] + Vector2r(diff_x, diff_y));
     }
 
     return translated;
 }
 
-std::shared_ptr<std::vector<Vector2f>> Polygon::translateVerticesPointer(const std::vector<Vector2f>& vertices, float diff_x, float diff_y)
+std::shared_ptr<std::vector<Vector2r>> Polygon::translateVerticesPointer(const std::vector<Vector2r>& vertices, Real diff_x, Real diff_y)
 {
     unsigned int sizeVertices = vertices.size();
-    std::shared_ptr<std::vector<Vector2f>> translated = std::make_shared<std::vector<Vector2f>>();
+    std::shared_ptr<std::vector<Vector2r>> translated = std::make_shared<std::vector<Vector2r>>();
 
     for (unsigned int i = 0; i < sizeVertices; i++){
-        translated->push_back(vertices[i] + Vector2f(diff_x, diff_y));
+        translated->push_back(vertices[i] + Vector2r(diff_x, diff_y));
     }
 
     return translated;
 }
 
-std::vector<Vector2f> Polygon::scaleVertices(const std::vector<Vector2f>& vertices,
-                                             float originalWidth, float originalHeight, float newWidth, float newHeight)
+std::vector<Vector2r> Polygon::scaleVertices(const std::vector<Vector2r>& vertices,
+                                             Real originalWidth, Real originalHeight, Real newWidth, Real newHeight)
 {
     unsigned int sizeVertices = vertices.size();
-    std::vector<Vector2f> scaled;
+    std::vector<Vector2r> scaled;
 
     for (unsigned int i = 0; i < sizeVertices; i++){
         scaled.push_back({((vertices[i].x + 1.0f) * newWidth / originalWidth) - 1.0f,
@@ -589,8 +1320,8 @@ std::vector<Vector2f> Polygon::scaleVertices(const std::vector<Vector2f>& vertic
     return scaled;
 }
 
-void Polygon::scaleXYMin(float* const originalXMin, float* const originalYMin,
-                         float originalWidth, float originalHeight, float newWidth, float newHeight)
+void Polygon::scaleXYMin(Real* const originalXMin, Real* const originalYMin,
+                         Real originalWidth, Real originalHeight, Real newWidth, Real newHeight)
 {
     if (originalXMin != nullptr){
         *originalXMin = ((*originalXMin + 1.0f) * newWidth / originalWidth) - 1.0f;
@@ -600,15 +1331,15 @@ void Polygon::scaleXYMin(float* const originalXMin, float* const originalYMin,
     }
 }
 
-void Polygon::createBoundingBoxVariables(const std::vector<Vector2f>& vertices, float& width, float& height, float& xMin, float& yMin){
+void Polygon::createBoundingBoxVariables(const std::vector<Vector2r>& vertices, Real& width, Real& height, Real& xMin, Real& yMin){
     unsigned int numberVertices = vertices.size();
-    float right = vertices[0].x;
-    float left = vertices[0].x;
-    float top = vertices[0].y;
-    float bottom = vertices[0].y;
+    Real right = vertices[0].x;
+    Real left = vertices[0].x;
+    Real top = vertices[0].y;
+    Real bottom = vertices[0].y;
     for (unsigned int i = 1; i < numberVertices; i++){
-        const float& x = vertices[i].x;
-        const float& y = vertices[i].y;
+        const Real& x = vertices[i].x;
+        const Real& y = vertices[i].y;
         if (x > right){
             right = x;
         } else if (x < left){
@@ -627,21 +1358,59 @@ void Polygon::createBoundingBoxVariables(const std::vector<Vector2f>& vertices,
     yMin = bottom;
 }
 
-bool Polygon::isPointBoundaryConcavePolygon(const Vector2f& point,
-                                            const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices){
-    Intersector inter;
+void Polygon::createBoundingBoxVariables(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                         Real& width, Real& height, Real& xMin, Real& yMin){
+    unsigned int numberIndices = indices.size();
+    if (numberIndices == 0){
+        width = 0.0f;
+        height = 0.0f;
+        xMin = 0.0f;
+        yMin = 0.0f;
+        return;
+    }
+    Real right = vertices[indices[0]].x;
+    Real left = vertices[indices[0]].x;
+    Real top = vertices[indices[0]].y;
+    Real bottom = vertices[indices[0]].y;
+    for (unsigned int i = 1; i < numberIndices; i++){
+        const Real& x = vertices[indices[i]].x;
+        const Real& y = vertices[indices[i]].y;
+        if (x > right){
+            right = x;
+        } else if (x < left){
+            left = x;
+        }
+        if (y > top){
+            top = y;
+        } else if (y < bottom){
+            bottom = y;
+        }
+    }
+
+    width = right - left;
+    height = top - bottom;
+    xMin = left;
+    yMin = bottom;
+}
+
+bool Polygon::isPointBoundaryConcavePolygon(const Vector2r& point,
+                                            const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
+    // the position of the point with respect to every edge is calculated at once
+    EdgeArrays edges;
+    Intersector::CreateEdgeArrays(vertices, indices, edges);
+    std::vector<RelativePosition> relativePositions;
+    Intersector::CalculateRelativePositions(edges, point, relativePositions);
+
     const unsigned int sizeIndices = indices.size();
     for (unsigned int i = 0; i < sizeIndices; i++){
         if (point == vertices[indices[i]] || point == vertices[indices[(i + 1) % sizeIndices]]){
             return true;
         }
-        inter.setSegment1(vertices[indices[i]], vertices[indices[(i + 1) % sizeIndices]]);
-        inter.setSegment2(vertices[indices[i]], point);
-        if (inter.calculateRelativePosition() == RelativePosition::Parallel){
-            const Vector2f diffVertices = vertices[indices[(i + 1) % sizeIndices]] - vertices[indices[i]];
-            const Vector2f diffIntersection = point - vertices[indices[i]];
+        if (relativePositions[i] == RelativePosition::Parallel){
+            const Vector2r diffVertices = vertices[indices[(i + 1) % sizeIndices]] - vertices[indices[i]];
+            const Vector2r diffIntersection = point - vertices[indices[i]];
             if (diffVertices.dot(diffIntersection) > 0.0 &&
-                Vector2f::IsFirstDoubleGreater(diffVertices.normSquared(), diffIntersection.normSquared())){
+                Vector2r::IsFirstDoubleGreater(diffVertices.normSquared(), diffIntersection.normSquared())){
                 return true;
             }
         }
@@ -649,12 +1418,12 @@ bool Polygon::isPointBoundaryConcavePolygon(const Vector2f& point,
     return false;
 }
 
-bool Polygon::isPointInsideConcavePolygon(const Vector2f& point,
-                                          const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices){
+bool Polygon::isPointInsideConcavePolygon(const Vector2r& point,
+                                          const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
     unsigned int numberPositive = 0;
     unsigned int numberNegative = 0;
 
-    const Vector2f& firstVector = {1, 1};
+    const Vector2r& firstVector = {1, 1};
 
     if (point == firstVector){
         LOG(LogLevel::WARN) << "Polygon::isPointInsideConcavePolygon: point is on vertex";
@@ -665,13 +1434,18 @@ bool Polygon::isPointInsideConcavePolygon(const Vector2f& point,
 
     inter.setSegment1(point, firstVector);
 
-    const Vector2f reference = firstVector - point;
+    const Vector2r reference = firstVector - point;
+
+    // every edge is intersected with the line at once
+    EdgeArrays edges;
+    Intersector::CreateEdgeArrays(vertices, indices, edges);
+    std::vector<LineSegmentIntersection> intersectionTypes;
+    std::vector<Vector2r> intersectionPoints;
+    inter.calculateLineSegmentIntersections(edges, intersectionTypes, intersectionPoints);
 
     unsigned int sizeIndices = indices.size();
     for (unsigned int i = 0; i < sizeIndices; i++){
-        inter.setSegment2(vertices[indices[i]], vertices[indices[(i + 1) % sizeIndices]]);
-
-        LineSegmentIntersection lineSegmentIntersection = inter.calculateLineSegmentIntersection();
+        LineSegmentIntersection lineSegmentIntersection = intersectionTypes[i];
 
 //        if (lineSegmentIntersection == LineSegmentIntersection::Parallel){
 //            LOG(LogLevel::WARN) << "line parallel";
@@ -680,8 +1454,8 @@ bool Polygon::isPointInsideConcavePolygon(const Vector2f& point,
         bool insideSegment = lineSegmentIntersection == LineSegmentIntersection::InsideSegment;
         bool secondVertex = lineSegmentIntersection == LineSegmentIntersection::SecondVertex;
         if (insideSegment || secondVertex){
-            const Vector2f intersectionPoint = inter.getIntersectionPoint();
-            const Vector2f difference = intersectionPoint - point;
+            const Vector2r intersectionPoint = intersectionPoints[i];
+            const Vector2r difference = intersectionPoint - point;
 
             double dot = reference.dot(difference);
 
@@ -698,7 +1472,7 @@ bool Polygon::isPointInsideConcavePolygon(const Vector2f& point,
                 }
             }
 
-            if (Vector2f::AreDoublesEqual(dot, 0.0)){
+            if (Vector2r::AreDoublesEqual(dot, 0.0)){
                 LOG(LogLevel::ERROR) << "dot is 0";
             } else if (dot > 0){
                 numberPositive++;
@@ -725,6 +1499,15 @@ bool Polygon::isPointInsideConcavePolygon(const Vector2f& point,
 
 // PRIVATE
 
+bool Polygon::isSegmentLineAwayFromBox() const{
+    // all the polygon is inside the bounding box
+    return EdgeTree::IsLineAwayFromBox(p1, p2, xMin, yMin, xMin + width, yMin + height);
+}
+
+bool Polygon::hasPointPool() const{
+    return &points != &ownPoints;
+}
+
 void Polygon::checkEnoughPointIndices() const{
     if (points.size() < 2){
         LOG(LogLevel::ERROR) << "number of points is less than 2";
@@ -735,21 +1518,190 @@ void Polygon::checkEnoughPointIndices() const{
     }
 }
 
-bool Polygon::checkIsPointIntersection(const Node* node) const{
-    const Node* next = node->next;
-    const Node* previous = node->previous;
-    if (!next || next == nullptr || !previous || previous == nullptr){
+void Polygon::calculateEdgeIntersections(const Intersector& inter, std::vector<LineSegmentIntersection>& types,
+                                         std::vector<Vector2r>& intersectionPoints){
+    if (!edgeTree){
+        // the edges of the body do not change, they are made for the first segment and kept for the next ones
+        if (workspace.bodyEdges.x1.size() != getNumberIndices()){
+            Intersector::CreateEdgeArrays(points, indices, workspace.bodyEdges);
+        }
+        inter.calculateLineSegmentIntersections(workspace.bodyEdges, types, intersectionPoints);
+        return;
+    }
+    // the edges the tree does not find are outside, just the others are intersected
+    std::vector<unsigned int>& nearEdges = workspace.nearEdges;
+    edgeTree->findLineEdges(p1, p2, nearEdges, workspace.treeStack);
+    Intersector::CreateEdgeArrays(edgeTree->getEdges(), nearEdges, workspace.nearEdgeArrays);
+    std::vector<LineSegmentIntersection>& nearTypes = workspace.nearTypes;
+    std::vector<Vector2r>& nearPoints = workspace.nearPoints;
+    inter.calculateLineSegmentIntersections(workspace.nearEdgeArrays, nearTypes, nearPoints);
+
+    types.assign(getNumberIndices(), LineSegmentIntersection::OutsideSegment);
+    intersectionPoints.resize(getNumberIndices());
+    const unsigned int numberNear = nearEdges.size();
+    for (unsigned int i = 0; i < numberNear; i++){
+        types[nearEdges[i]] = nearTypes[i];
+        intersectionPoints[nearEdges[i]] = nearPoints[i];
+    }
+}
+
+void Polygon::calculateBoundaryAntiClockwise(std::vector<Index>& boundary,
+                                             Real& boxXMin, Real& boxYMin, Real& boxXMax, Real& boxYMax) const{
+    const unsigned int numberIndices = getNumberIndices();
+    boundary = indices;
+    double doubleArea = 0.0;
+    for (unsigned int i = 0; i < numberIndices; i++){
+        const Vector2r& first = points[boundary[i]];
+        const Vector2r& second = points[boundary[(i + 1) % numberIndices]];
+        doubleArea += (double)first.x * second.y - (double)second.x * first.y;
+    }
+    if (doubleArea < 0.0){
+        std::reverse(boundary.begin(), boundary.end());
+    }
+
+    // points is shared by all the polygons of an element, so the bounding box is the one of the indices
+    boxXMin = points[boundary[0]].x;
+    boxYMin = points[boundary[0]].y;
+    boxXMax = boxXMin;
+    boxYMax = boxYMin;
+    for (unsigned int i = 1; i < numberIndices; i++){
+        const Vector2r& point = points[boundary[i]];
+        boxXMin = std::min(boxXMin, point.x);
+        boxYMin = std::min(boxYMin, point.y);
+        boxXMax = std::max(boxXMax, point.x);
+        boxYMax = std::max(boxYMax, point.y);
+    }
+}
+
+unsigned int Polygon::findOrAddPoint(const Vector2r& point, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                                     double tolerance){
+    unsigned int index;
+    if (grid.find(point, points, index, tolerance)){
+        return index;
+    }
+    points.push_back(point);
+    if (points.size() == PolygonSet::MAX_NUMBER_POINTS + 1){
+        LOG(LogLevel::ERROR) << "more than " << PolygonSet::MAX_NUMBER_POINTS << " points, the indices are too narrow";
+    }
+    // extraPoint is the point pool itself when the polygon has one
+    if (&extraPoint != &points){
+        extraPoint.push_back(point);
+    }
+    grid.add(point, points.size() - 1);
+    return points.size() - 1;
+}
+
+bool Polygon::IsPointInsideSimplePolygon(const Vector2r& point,
+                                         const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
+    // number of edges crossed by the horizontal half line on the right of the point
+    bool inside = false;
+    const unsigned int numberIndices = indices.size();
+    for (unsigned int i = 0; i < numberIndices; i++){
+        const Vector2r& first = vertices[indices[i]];
+        const Vector2r& second = vertices[indices[(i + 1) % numberIndices]];
+        if ((first.y > point.y) != (second.y > point.y)){
+            const double x = first.x + ((double)point.y - first.y) * ((double)second.x - first.x) / ((double)second.y - first.y);
+            if (point.x < x){
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+void Polygon::TraceFaces(const std::vector<Vector2r>& vertices, const std::vector<Index>& boundary,
+                         const std::vector<std::pair<unsigned int, unsigned int>>& chords,
+                         PolygonSet& faces){
+    // half edge h goes from origins[h] to origins[h ^ 1]
+    std::vector<unsigned int> origins;
+    std::unordered_set<uint64_t> edges;
+    auto addEdge = [&origins, &edges](unsigned int first, unsigned int second){
+        const uint64_t key = ((uint64_t)std::min(first, second) << 32) | std::max(first, second);
+        if (first == second || !edges.insert(key).second){
+            return;
+        }
+        origins.push_back(first);
+        origins.push_back(second);
+    };
+    const unsigned int numberBoundary = boundary.size();
+    for (unsigned int i = 0; i < numberBoundary; i++){
+        addEdge(boundary[i], boundary[(i + 1) % numberBoundary]);
+    }
+    for (const std::pair<unsigned int, unsigned int>& chord : chords){
+        addEdge(chord.first, chord.second);
+    }
+    const unsigned int numberHalfEdges = origins.size();
+
+    // half edges leaving every vertex sorted anti-clockwise, with the position of each half edge in its list
+    std::vector<unsigned int> vertexIndices(origins);
+    std::sort(vertexIndices.begin(), vertexIndices.end());
+    vertexIndices.erase(std::unique(vertexIndices.begin(), vertexIndices.end()), vertexIndices.end());
+    std::vector<std::vector<unsigned int>> leaving(vertexIndices.size());
+    std::vector<unsigned int> vertexOf(numberHalfEdges);
+    for (unsigned int h = 0; h < numberHalfEdges; h++){
+        vertexOf[h] = std::lower_bound(vertexIndices.begin(), vertexIndices.end(), origins[h]) - vertexIndices.begin();
+        leaving[vertexOf[h]].push_back(h);
+    }
+    std::vector<double> angles(numberHalfEdges);
+    for (unsigned int h = 0; h < numberHalfEdges; h++){
+        const Vector2r& origin = vertices[origins[h]];
+        const Vector2r& target = vertices[origins[h ^ 1]];
+        angles[h] = atan2((double)target.y - origin.y, (double)target.x - origin.x);
+    }
+    std::vector<unsigned int> positions(numberHalfEdges);
+    for (std::vector<unsigned int>& halfEdges : leaving){
+        std::sort(halfEdges.begin(), halfEdges.end(), [&angles](unsigned int a, unsigned int b){
+            return angles[a] < angles[b];
+        });
+        for (unsigned int k = 0; k < halfEdges.size(); k++){
+            positions[halfEdges[k]] = k;
+        }
+    }
+
+    // every half edge is walked, the face outside the boundary is the only one going clockwise and it is discarded
+    std::vector<bool> walked(numberHalfEdges, false);
+    for (unsigned int start = 0; start < numberHalfEdges; start++){
+        if (walked[start]){
+            continue;
+        }
+        // the face is traced at the end of faces and removed if it is not kept
+        faces.startPolygon();
+        unsigned int h = start;
+        double doubleArea = 0.0;
+        bool closed = false;
+        for (unsigned int step = 0; step < numberHalfEdges; step++){
+            walked[h] = true;
+            faces.addIndex(origins[h]);
+            const Vector2r& origin = vertices[origins[h]];
+            const Vector2r& target = vertices[origins[h ^ 1]];
+            doubleArea += (double)origin.x * target.y - (double)target.x * origin.y;
+            // the half edge back is h ^ 1, the next one is the first clockwise from it
+            const std::vector<unsigned int>& next = leaving[vertexOf[h ^ 1]];
+            h = next[(positions[h ^ 1] + next.size() - 1) % next.size()];
+            if (h == start){
+                closed = true;
+                break;
+            }
+        }
+        if (!closed){
+            LOG(LogLevel::ERROR) << "Polygon::TraceFaces: face is not closed";
+            faces.removeLastPolygon();
+        } else if (doubleArea <= 0.0 || faces.back().size() <= 2){
+            faces.removeLastPolygon();
+        }
+    }
+}
+
+bool Polygon::checkIsPointIntersection(unsigned int node) const{
+    const unsigned int next = network->next[node];
+    const unsigned int previous = network->previous[node];
+    if (next == Network::NONE || previous == Network::NONE){
         LOG(LogLevel::WARN) << "node is not connected";
         return false;
     }
-    Intersector inter;
-    inter.setSegment1(p1, points[next->getIndex()]);
-    inter.setSegment2(p2, points[next->getIndex()]);
-    RelativePosition relNext = inter.calculateRelativePosition();
-
-    inter.setSegment1(p1, points[previous->getIndex()]);
-    inter.setSegment2(p2, points[previous->getIndex()]);
-    RelativePosition relPreviuos = inter.calculateRelativePosition();
+    // sides of next and previous with respect to the segment, exact so they are parallel only if they lie on the line
+    RelativePosition relNext = Predicates::CalculateRelativePosition(p1, p2, p1, points[network->getIndex(next)]);
+    RelativePosition relPreviuos = Predicates::CalculateRelativePosition(p1, p2, p1, points[network->getIndex(previous)]);
 
     if (relNext == RelativePosition::Parallel){
         LOG(LogLevel::WARN) << "relative position next is parallel when deciding point intersection";
@@ -766,10 +1718,14 @@ bool Polygon::checkIsPointIntersection(const Node* node) const{
 }
 
 void Polygon::addSegmentPointsToNetwork(){
-    bool insideP1 = !Polygon::isPointBoundaryConcavePolygon(p1, points, indices) &&
-                     Polygon::isPointInsideConcavePolygon(p1, points, indices);
-    bool insideP2 = !Polygon::isPointBoundaryConcavePolygon(p2, points, indices) &&
-                     Polygon::isPointInsideConcavePolygon(p2, points, indices);
+    // the body is prepared for the first segment and kept for the next ones
+    if (!workspace.preparedBody){
+        const std::vector<Vector2r> bodyPoints(points.begin(), points.begin() + numberBodyPoints);
+        workspace.preparedBody = std::make_unique<PreparedPolygon>(bodyPoints, indices);
+    }
+    const PreparedPolygon& body = *workspace.preparedBody;
+    bool insideP1 = !body.isPointBoundary(p1) && body.isPointInside(p1, workspace.queryBuffers);
+    bool insideP2 = !body.isPointBoundary(p2) && body.isPointInside(p2, workspace.queryBuffers);
 
     if (!insideP1 && !insideP2){
         LOG(LogLevel::INFO) << "Both segment points are not inside polygon";
@@ -781,84 +1737,84 @@ void Polygon::addSegmentPointsToNetwork(){
     bool foundP1 = false;
     bool foundP2 = false;
 
-    Node* node = startNode;
-    const Vector2f segment = p2 - p1;
-    while (node != nullptr){
-        if (node->down != nullptr){
+    Network& net = *network;
+    unsigned int node = startNode;
+    const Vector2r segment = p2 - p1;
+    while (node != Network::NONE){
+        if (net.down[node] != Network::NONE){
             double dotP1 = 0.0;
-            Vector2f diffNode = points[node->getIndex()] - p1;
-            Vector2f diffDown = points[node->down->getIndex()] - p1;
+            Vector2r diffNode = points[net.getIndex(node)] - p1;
+            Vector2r diffDown = points[net.getIndex(net.down[node])] - p1;
             if (!foundP1 && diffDown.dot(segment) < dotP1 &&
                             diffNode.dot(segment) > dotP1){
                 points.push_back(p1);
-                Node* down = node->down;
-                Node* nodeP1 = new Node(points.size() - 1);
-                down->up = nodeP1;
-                nodeP1->down = down;
-                nodeP1->up = node;
-                node->down = nodeP1;
+                unsigned int down = net.down[node];
+                unsigned int nodeP1 = net.create(points.size() - 1);
+                net.up[down] = nodeP1;
+                net.down[nodeP1] = down;
+                net.up[nodeP1] = node;
+                net.down[node] = nodeP1;
 
                 foundP1 = true;
 
-                LOG(LogLevel::INFO) << "added segment point " << 1 << " -> down: " << down->getIndex() << ", up: " << node->getIndex();
+                LOG(LogLevel::INFO) << "added segment point " << 1 << " -> down: " << net.getIndex(down) << ", up: " << net.getIndex(node);
             }
             double dotP2 = segment.dot(segment);
-            diffDown = points[node->down->getIndex()] - p1;
+            diffDown = points[net.getIndex(net.down[node])] - p1;
             if (!foundP2 && diffDown.dot(segment) < dotP2 &&
                             diffNode.dot(segment) > dotP2){
                 points.push_back(p2);
-                Node* down = node->down;
-                Node* nodeP2 = new Node(points.size() - 1);
-                down->up = nodeP2;
-                nodeP2->down = down;
-                nodeP2->up = node;
-                node->down = nodeP2;
+                unsigned int down = net.down[node];
+                unsigned int nodeP2 = net.create(points.size() - 1);
+                net.up[down] = nodeP2;
+                net.down[nodeP2] = down;
+                net.up[nodeP2] = node;
+                net.down[node] = nodeP2;
 
                 foundP2 = true;
 
-                LOG(LogLevel::INFO) << "added segment point " << 2 << " -> down: " << down->getIndex() << ", up: " << node->getIndex();
+                LOG(LogLevel::INFO) << "added segment point " << 2 << " -> down: " << net.getIndex(down) << ", up: " << net.getIndex(node);
             }
             if (foundP1 && foundP2){
                 break;
             }
         }
-        node = node->up;
+        node = net.up[node];
     }
 }
 
-const Node* Polygon::getNextNotBetween(const Node* node, bool upDirection){
-    while (node != nullptr && node->isBetween()){
+unsigned int Polygon::getNextNotBetween(unsigned int node, bool upDirection){
+    while (node != Network::NONE && network->isBetween(node)){
         if (upDirection){
-            node = node->up;
+            node = network->up[node];
         } else{
-            node = node->down;
+            node = network->down[node];
         }
     }
     return node;
 }
 
-const Node* Polygon::getNextNotBetween(const Node* node, bool upDirection, std::vector<unsigned int>& indicesPoli){
-    while (node != nullptr && node->isBetween()){
-        indicesPoli.push_back(node->getIndex());
-        LOG(LogLevel::INFO) << "at segment point: " << node->getIndex();
+unsigned int Polygon::getNextNotBetween(unsigned int node, bool upDirection, PolygonSet& indicesPoli){
+    while (node != Network::NONE && network->isBetween(node)){
+        indicesPoli.addIndex(network->getIndex(node));
+        LOG(LogLevel::INFO) << "at segment point: " << network->getIndex(node);
         if (upDirection){
-            node = node->up;
+            node = network->up[node];
         } else{
-            node = node->down;
+            node = network->down[node];
         }
     }
     return node;
 }
 
 void Polygon::calculateOrientation(){
-    if (!startNode->up || startNode->up == nullptr){
+    const Network& net = *network;
+    if (net.up[startNode] == Network::NONE){
         LOG(LogLevel::WARN) << "start node does not have up, orientation set to positive";
         orientation = RelativePosition::Positive;
     } else{
-        Intersector inter;
-        inter.setSegment1(points[startNode->previous->getIndex()], points[startNode->up->getIndex()]);
-        inter.setSegment2(points[startNode->next->getIndex()], points[startNode->up->getIndex()]);
-        orientation = inter.calculateRelativePosition();
+        orientation = Predicates::CalculateRelativePosition(points[net.getIndex(net.previous[startNode])],
+                                                            points[net.getIndex(net.next[startNode])], p1, p2);
         if (orientation == RelativePosition::Parallel){
             //throw std::runtime_error("Error when calculating orientation");
             LOG(LogLevel::WARN) << "orientation is parallel, set to positive";
@@ -868,371 +1824,200 @@ void Polygon::calculateOrientation(){
     LOG(LogLevel::INFO) << "orientation: " << orientation;
 }
 
-const Node* Polygon::getNextIntersection(const Node *node){
-    if (!node->isIntersection()){
-        LOG(LogLevel::WARN) << node->getIndex() << " returned nullptr from Polygon::getNextIntersection";
-        return nullptr;
-    }
-    if (node->up == nullptr){
-        LOG(LogLevel::INFO) << node->getIndex() << " border node";
-        return getNextNotBetween(node->down, false);
-    }
-    if (node->down == nullptr){
-        LOG(LogLevel::INFO) << node->getIndex() << " border node";
-        return getNextNotBetween(node->up, true);
-    }
-    Intersector inter;
-    inter.setSegment1(points[node->previous->getIndex()], points[node->up->getIndex()]);
-    inter.setSegment2(points[node->next->getIndex()], points[node->up->getIndex()]);
-    if (inter.calculateRelativePosition() == orientation){
-        LOG(LogLevel::INFO) << node->getIndex() << " same orientation";
-        return getNextNotBetween(node->up, true);
+unsigned int Polygon::getNextIntersection(unsigned int node){
+    const Network& net = *network;
+    if (!net.isIntersection(node)){
+        LOG(LogLevel::WARN) << net.getIndex(node) << " returned not linked from Polygon::getNextIntersection";
+        return Network::NONE;
+    }
+    if (net.up[node] == Network::NONE){
+        LOG(LogLevel::INFO) << net.getIndex(node) << " border node";
+        return getNextNotBetween(net.down[node], false);
+    }
+    if (net.down[node] == Network::NONE){
+        LOG(LogLevel::INFO) << net.getIndex(node) << " border node";
+        return getNextNotBetween(net.up[node], true);
+    }
+    RelativePosition position = Predicates::CalculateRelativePosition(points[net.getIndex(net.previous[node])],
+                                                                      points[net.getIndex(net.next[node])], p1, p2);
+    if (position == orientation){
+        LOG(LogLevel::INFO) << net.getIndex(node) << " same orientation";
+        return getNextNotBetween(net.up[node], true);
     } else{
-        LOG(LogLevel::INFO) << node->getIndex() << " opposite orientation";
-        return getNextNotBetween(node->down, false);
+        LOG(LogLevel::INFO) << net.getIndex(node) << " opposite orientation";
+        return getNextNotBetween(net.down[node], false);
     }
 }
 
-const Node* Polygon::getNextIntersectionAdding(const Node* node, std::vector<unsigned int>& indicesPoli){
-    if (!node->isIntersection()){
-        LOG(LogLevel::WARN) << node->getIndex() << " returned nullptr from Polygon::getNextIntersection";
-        return nullptr;
-    }
-    if (node->up == nullptr){
-        LOG(LogLevel::INFO) << node->getIndex() << " border node";
-        return getNextNotBetween(node->down, false, indicesPoli);
-    }
-    if (node->down == nullptr){
-        LOG(LogLevel::INFO) << node->getIndex() << " border node";
-        return getNextNotBetween(node->up, true, indicesPoli);
-    }
-    Intersector inter;
-    inter.setSegment1(points[node->previous->getIndex()], points[node->up->getIndex()]);
-    inter.setSegment2(points[node->next->getIndex()], points[node->up->getIndex()]);
-    if (inter.calculateRelativePosition() == orientation){
-        LOG(LogLevel::INFO) << node->getIndex() << " same orientation";
-        return getNextNotBetween(node->up, true, indicesPoli);
+unsigned int Polygon::getNextIntersectionAdding(unsigned int node, PolygonSet& indicesPoli){
+    const Network& net = *network;
+    if (!net.isIntersection(node)){
+        LOG(LogLevel::WARN) << net.getIndex(node) << " returned not linked from Polygon::getNextIntersection";
+        return Network::NONE;
+    }
+    if (net.up[node] == Network::NONE){
+        LOG(LogLevel::INFO) << net.getIndex(node) << " border node";
+        return getNextNotBetween(net.down[node], false, indicesPoli);
+    }
+    if (net.down[node] == Network::NONE){
+        LOG(LogLevel::INFO) << net.getIndex(node) << " border node";
+        return getNextNotBetween(net.up[node], true, indicesPoli);
+    }
+    RelativePosition position = Predicates::CalculateRelativePosition(points[net.getIndex(net.previous[node])],
+                                                                      points[net.getIndex(net.next[node])], p1, p2);
+    if (position == orientation){
+        LOG(LogLevel::INFO) << net.getIndex(node) << " same orientation";
+        return getNextNotBetween(net.up[node], true, indicesPoli);
     } else{
-        LOG(LogLevel::INFO) << node->getIndex() << " opposite orientation";
-        return getNextNotBetween(node->down, false, indicesPoli);
+        LOG(LogLevel::INFO) << net.getIndex(node) << " opposite orientation";
+        return getNextNotBetween(net.down[node], false, indicesPoli);
     }
 }
 
-void Polygon::sortIntersectionsNetwork(const std::vector<Node*>& nodes){
+void Polygon::sortIntersectionsNetwork(const std::vector<unsigned int>& nodes){
     unsigned int nodesLenght = nodes.size();
     if (nodesLenght == 0){
         return;
     }
 
-    if (startNode == nullptr){
-        LOG(LogLevel::ERROR) << "start node is nullptr";
+    if (startNode == Network::NONE){
+        LOG(LogLevel::ERROR) << "start node is not linked";
         exit(-1);
     }
-    startNode->down = startNode;
-    Node* minNode = startNode;
-    Node* node = startNode;
-
-    const Vector2f segment = p2 - p1;
-    for (unsigned int i = 1; i < nodesLenght; i++){
-        //LOG(LogLevel::DEBUG) << "node: " << minNode->getIndex();
-        double minProduct = Polygon::BIG_DOUBLE;
-        for (unsigned int n = 0; n < nodesLenght; n++){
-            if (nodes[n]->down == nullptr){
-                double product = segment.dot(points[nodes[n]->getIndex()] - p1);
-                if (product < minProduct){
-                    minProduct = product;
-                    minNode = nodes[n];
-                }
-            }
-        }
-        minNode->down = node;
-        node->up = minNode;
-        node = minNode;
-    }
-    startNode->down = nullptr;
-}
-
-void Polygon::continueSmallPolygon(const Node* node, const Node* initialNode, std::vector<unsigned int>& indicesPoli,
-                                   std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices){
-    // first we add the node we currently are at to the list of indices of the small polygon
-    indicesPoli.push_back(node->getIndex());
-    node = node->next;
+    Network& net = *network;
 
-    // we loop and add the nodes while we are not at an intersection node
-    unsigned int previous = node->previous->getIndex();
-    unsigned int now;
-    while (!node->isIntersection() && node != initialNode) {
-        now = node->getIndex();
-        // we check that we don't add the same index two times
-        // this happens very rarely, when there are a lot of vertices on the borders
-        if (now == previous){
-            LOG(LogLevel::WARN) << now << " same index as node before";
-        } else{
-            indicesPoli.push_back(node->getIndex());
+    // the dot product of every intersection is computed just once and then the nodes are sorted on it
+    // start node has the lowest product so it is left out, it will be the bottom of the chain
+    const Vector2r segment = p2 - p1;
+    std::vector<std::pair<double, unsigned int>>& products = workspace.products;
+    products.clear();
+    for (unsigned int n = 0; n < nodesLenght; n++){
+        if (nodes[n] != startNode){
+            products.emplace_back(segment.dot(points[net.getIndex(nodes[n])] - p1), n);
         }
-        previous = now;
-        LOG(LogLevel::INFO) << "at " << node->getIndex();
-        node = node->next;
     }
+    // nodes with the same product stay in the order they were found, as when they were picked one by one,
+    // because they are sorted also on their position (std::stable_sort would allocate a buffer every time)
+    std::sort(products.begin(), products.end());
 
-    LOG(LogLevel::INFO) << node->getIndex() << " arrived";
-    // if the node we are arrived at is the starting node, we are finished, the small polygon is closed
-    if (node != initialNode){
-        indicesPoli.push_back(node->getIndex());
-    } else{
-        // it happens very rarely when there are two intersection one after the other in really complex polygons
-        LOG(LogLevel::WARN) << node->getIndex() << " closing polygon other way";
-        indicesPoli.push_back(node->getIndex());
-    }
-
-    if (!node->touched){
-        LOG(LogLevel::INFO) << node->getIndex() << " is not already touched";
-        node->touched = true;
-        const Node* nodeCreation = node;
-        node = !alsoSegmentPoints ? getNextIntersection(node) : getNextIntersectionAdding(node, indicesPoli);
-        // here is where we will close the polygon
-        if (node == initialNode){
-            LOG(LogLevel::INFO) << node->getIndex() << " closing polygon";
-        }
-        // in the past: sometimes getNextIntersection returns a nullptr,
-        // this happens very rarely when there are a lot of points and intersections
-        // and intersector thinks that certain lines are parallel when in reality are not
-        // now it is solved because we no longer loop until relative position change but until we reach an intersection node
-        if (node != nullptr && node != initialNode){
-            node->touched = true;
-            LOG(LogLevel::INFO) << node->getIndex() << " continue samll polygon";
-            // first we continue the small polygon we are creating
-            continueSmallPolygon(node, initialNode, indicesPoli, polygonsIndices);
-        }
-        // here we create a new small polygon
-        LOG(LogLevel::INFO) << nodeCreation->getIndex() << " create samll polygon";
-        polygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>());
-        // we add a new array to the big array of arrays
-        std::vector<unsigned int>& indicesPoliCreation = *polygonsIndices[polygonsIndices.size() - 1];
-        continueSmallPolygon(nodeCreation, nodeCreation, indicesPoliCreation, polygonsIndices);
-    } else{
-        LOG(LogLevel::INFO) << node->getIndex() << " is already touched";
-        if (alsoSegmentPoints){
-            LOG(LogLevel::INFO) << "returning to start";
-            const Node* arrivedNode = getNextIntersectionAdding(node, indicesPoli);
-            if (arrivedNode != initialNode){
-                LOG(LogLevel::WARN) << "arrived node is not initial node";
-            }
-        }
+    unsigned int node = startNode;
+    for (const std::pair<double, unsigned int>& product : products){
+        const unsigned int nodeProduct = nodes[product.second];
+        net.down[nodeProduct] = node;
+        net.up[node] = nodeProduct;
+        node = nodeProduct;
     }
 }
 
-void Polygon::continueSmallPolygonInsideOutside(const Node* node, const Node* initialNode,
-    std::shared_ptr<std::vector<unsigned int>> indicesPoliPoi,
-    std::vector<std::shared_ptr<std::vector<unsigned int>>>& insidePolygonsIndices,
-    std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsidePolygonsIndices){
-
-    // this check is used when the small polygon is just created and the relative position is parallel
-    // becuse we are starting from an intersection point, if we not change it we will never enter in the while loop
-    // we have to decide if the new small polygon is inside or outside
-
-    if (indicesPoliPoi == nullptr){
-        Intersector inter;
-        Node* tryNode = node->next;
-        RelativePosition relativePosition = RelativePosition::Parallel;
-        while (relativePosition == RelativePosition::Parallel && tryNode != node){
-            // here we compute the intersection with the two points in order to find if we are arrived at an intersection point
-            Intersector inter;
-            inter.setSegment1(p1, points[tryNode->getIndex()]);
-            inter.setSegment2(p2, points[tryNode->getIndex()]);
-            relativePosition = inter.calculateRelativePosition();
-            tryNode = tryNode->next;
-        }
-        if (relativePosition == RelativePosition::Positive){
-            insidePolygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>());
-            indicesPoliPoi = insidePolygonsIndices[insidePolygonsIndices.size() - 1];
-        } else if (relativePosition == RelativePosition::Negative){
-            outsidePolygonsIndices.push_back(std::make_shared<std::vector<unsigned int>>());
-            indicesPoliPoi = outsidePolygonsIndices[outsidePolygonsIndices.size() - 1];
-        } else if (relativePosition == RelativePosition::Parallel){
-//            relativePosition = RelativePosition::Positive;
-            LOG(LogLevel::ERROR) << "relative position is parallel every time";
-            return;
-        }
-    }
-
-    if (!indicesPoliPoi || indicesPoliPoi == nullptr){
-        LOG(LogLevel::ERROR) << "indices poli pointer is nullptr";
-        return;
-    }
-    std::vector<unsigned int>& indicesPoli = *indicesPoliPoi;
-
+unsigned int Polygon::addNodesUntilIntersection(unsigned int node, unsigned int initialNode, PolygonSet& indicesPoli){
+    const Network& net = *network;
     // first we add the node we currently are at to the list of indices of the small polygon
-    indicesPoli.push_back(node->getIndex());
-    node = node->next;
+    indicesPoli.addIndex(net.getIndex(node));
+    node = net.next[node];
 
     // we loop and add the nodes while we are not at an intersection node
-    unsigned int previous = node->previous->getIndex();
+    unsigned int previous = net.getIndex(net.previous[node]);
     unsigned int now;
-    while (!node->isIntersection() && node != initialNode) {
-        now = node->getIndex();
+    while (!net.isIntersection(node) && node != initialNode) {
+        now = net.getIndex(node);
         // we check that we don't add the same index two times
         // this happens very rarely, when there are a lot of vertices on the borders
         if (now == previous){
             LOG(LogLevel::WARN) << now << " same index as node before";
         } else{
-            indicesPoli.push_back(node->getIndex());
+            indicesPoli.addIndex(net.getIndex(node));
         }
         previous = now;
-        LOG(LogLevel::INFO) << "at " << node->getIndex();
-        node = node->next;
+        LOG(LogLevel::INFO) << "at " << net.getIndex(node);
+        node = net.next[node];
     }
 
-    LOG(LogLevel::INFO) << node->getIndex() << " arrived";
+    LOG(LogLevel::INFO) << net.getIndex(node) << " arrived";
 
     // if the node we are arrived at is the starting node, we are finished, the small polygon is closed
-    indicesPoli.push_back(node->getIndex());
+    indicesPoli.addIndex(net.getIndex(node));
 
     if (node == initialNode){
         // it happens very rarely when there are two intersection one after the other in really complex polygons
-        LOG(LogLevel::WARN) << node->getIndex() << " closing polygon other way";
-    }
-    if (!node->touched){
-        LOG(LogLevel::INFO) << node->getIndex() << " is not already touched";
-        node->touched = true;
-        const Node* nodeCreation = node;
-        node = getNextIntersection(node);
-        // here is where we will close the polygon
-        if (node == initialNode){
-            LOG(LogLevel::INFO) << node->getIndex() << " closing polygon";
-        }
-        // in the past: sometimes getNextIntersection returns a nullptr,
-        // this happens very rarely when there are a lot of points and intersections
-        // and intersector thinks that certain lines are parallel when in reality are not
-        // now it is solved because we no longer loop until relative position change but until we reach an intersection node
-        if (node != nullptr && node != initialNode){
-            node->touched = true;
-            LOG(LogLevel::INFO) << node->getIndex() << " continue samll polygon";
-            // first we continue the small polygon we are creating
-
-            continueSmallPolygonInsideOutside(node, initialNode, indicesPoliPoi,
-                                              insidePolygonsIndices, outsidePolygonsIndices);
-        }
-        // here we create a new small polygon
-        LOG(LogLevel::INFO) << nodeCreation->getIndex() << " create samll polygon";
-
-        // we add a new array to the big array of arrays
-        continueSmallPolygonInsideOutside(nodeCreation, nodeCreation, nullptr,
-                                          insidePolygonsIndices, outsidePolygonsIndices);
-    } else{
-        LOG(LogLevel::INFO) << node->getIndex() << " is already touched";
+        LOG(LogLevel::WARN) << net.getIndex(node) << " closing polygon other way";
     }
+    return node;
 }
 
-void Polygon::continueSmallPolygonInsideOutsideConcave(const Node* node, const Node* initialNode,
-    std::shared_ptr<std::vector<unsigned int>> indicesPoliPoi,
-    std::vector<std::shared_ptr<std::vector<unsigned int>>>& insidePolygonsIndices,
-    std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsidePolygonsIndices,
-    const std::vector<Vector2f>& concaveVertices, const std::vector<unsigned int>& concaveIndices){
-
-    bool closing = false;
-
-    if (indicesPoliPoi == nullptr){
-        indicesPoliPoi = std::make_shared<std::vector<unsigned int>>();
-    }
-
-    if (!indicesPoliPoi || indicesPoliPoi == nullptr){
-        LOG(LogLevel::ERROR) << "indices poli pointer is nullptr";
-        return;
-    }
-    std::vector<unsigned int>& indicesPoli = *indicesPoliPoi;
-
-    // first we add the node we currently are at to the list of indices of the small polygon
-    indicesPoli.push_back(node->getIndex());
-    node = node->next;
-
-    // we loop and add the nodes while we are not at an intersection node
-    unsigned int previous = node->previous->getIndex();
-    unsigned int now;
-    while (!node->isIntersection() && node != initialNode) {
-        now = node->getIndex();
-        // we check that we don't add the same index two times
-        // this happens very rarely, when there are a lot of vertices on the borders
-        if (now == previous){
-            LOG(LogLevel::WARN) << now << " same index as node before";
-        } else{
-            indicesPoli.push_back(node->getIndex());
-        }
-        previous = now;
-        LOG(LogLevel::INFO) << "at " << node->getIndex();
-        node = node->next;
-    }
-
-    LOG(LogLevel::INFO) << node->getIndex() << " arrived";
-
-    // if the node we are arrived at is the starting node, we are finished, the small polygon is closed
-    indicesPoli.push_back(node->getIndex());
-
-    if (node == initialNode){
-        // it happens very rarely when there are two intersection one after the other in really complex polygons
-        LOG(LogLevel::WARN) << node->getIndex() << " closing polygon other way";
-    }
-    if (!node->touched){
-        LOG(LogLevel::INFO) << node->getIndex() << " is not already touched";
-        node->touched = true;
-        const Node* nodeCreation = node;
-        node = getNextIntersection(node);
-        if (node == nullptr){
-            LOG(LogLevel::ERROR) << "getNextIntersection returned nullptr";
-            return;
-        }
-        // here is where we will close the polygon
-        if (node == initialNode){
-            LOG(LogLevel::INFO) << node->getIndex() << " closing polygon";
-        }
-        // in the past: sometimes getNextIntersection returns a nullptr,
-        // this happens very rarely when there are a lot of points and intersections
-        // and intersector thinks that certain lines are parallel when in reality are not
-        // now it is solved because we no longer loop until relative position change but until we reach an intersection node
-        if (node != initialNode){
-            node->touched = true;
-            LOG(LogLevel::INFO) << node->getIndex() << " continue samll polygon";
-            // first we continue the small polygon we are creating
-
-            continueSmallPolygonInsideOutsideConcave(node, initialNode, indicesPoliPoi,
-                                              insidePolygonsIndices, outsidePolygonsIndices, concaveVertices, concaveIndices);
-        } else{
-            closing = true;
+template<typename Pieces>
+void Polygon::cutSmallPolygons(unsigned int startNode, Pieces& pieces){
+    Network& net = *network;
+
+    // a task is an intersection node from where a new small polygon has to be created
+    // or NONE for a small polygon closed going back to its initial node, that is closed after the one created from there
+    // (it is kept by the pieces policy until then), the last task added is done first,
+    // so the small polygons are created in the same order as when the function called itself for each of them
+    std::vector<unsigned int>& tasks = workspace.tasks;
+    tasks.clear();
+    tasks.reserve(numberIntersections);
+    tasks.push_back(startNode);
+
+    unsigned int node = Network::NONE;
+    unsigned int initialNode = Network::NONE;
+    typename Pieces::Piece indicesPoli = nullptr;
+    while (true){
+        if (indicesPoli == nullptr){
+            if (tasks.empty()){
+                return;
+            }
+            node = tasks.back();
+            tasks.pop_back();
+            if (node == Network::NONE){
+                pieces.closeDeferred();
+                continue;
+            }
+            // here we create a new small polygon
+            initialNode = node;
+            LOG(LogLevel::INFO) << net.getIndex(node) << " create samll polygon";
+            indicesPoli = pieces.create(node);
+            if (indicesPoli == nullptr){
+                continue;
+            }
         }
-        // here we create a new small polygon
-        LOG(LogLevel::INFO) << nodeCreation->getIndex() << " create samll polygon";
 
-        // we add a new array to the big array of arrays
-        continueSmallPolygonInsideOutsideConcave(nodeCreation, nodeCreation, nullptr,
-                                          insidePolygonsIndices, outsidePolygonsIndices, concaveVertices, concaveIndices);
-    } else{
-        LOG(LogLevel::INFO) << node->getIndex() << " is already touched";
-        closing = true;
-    }
-    if (closing){
-        // we decide if the polygon is inside or outside
-        bool allBoundary = false;
-        unsigned int correctIndex = 0;
+        node = addNodesUntilIntersection(node, initialNode, *indicesPoli);
 
-        unsigned int sizeIndicesPoli = indicesPoli.size();
-        for (unsigned int i = 0; i < sizeIndicesPoli; i++){
-            if (!isPointBoundaryConcavePolygon(points[indicesPoli[i]], concaveVertices, concaveIndices)){
-                correctIndex = i;
-                break;
+        if (!net.touched[node]){
+            LOG(LogLevel::INFO) << net.getIndex(node) << " is not already touched";
+            net.touched[node] = true;
+            const unsigned int nodeCreation = node;
+            if constexpr (Pieces::SEGMENT_POINTS){
+                node = getNextIntersectionAdding(node, *indicesPoli);
+            } else{
+                node = getNextIntersection(node);
             }
-            if (i == sizeIndicesPoli - 1){
-                allBoundary = true;
+            // in the past: sometimes getNextIntersection returns a nullptr,
+            // this happens very rarely when there are a lot of points and intersections
+            // and intersector thinks that certain lines are parallel when in reality are not
+            // now it is solved because we no longer loop until relative position change but until we reach an intersection node
+            if (node != Network::NONE && node != initialNode){
+                net.touched[node] = true;
+                LOG(LogLevel::INFO) << net.getIndex(node) << " continue samll polygon";
+                // first we continue the small polygon we are creating, then we create the one starting here
+                tasks.push_back(nodeCreation);
+                continue;
             }
-        }
-
-        const Vector2f& point = points[indicesPoli[correctIndex]];
-        if (allBoundary){
-            LOG(LogLevel::INFO) << "Polygon::continueSmallPolygonInsideOutsideConcave: all points are boundary concave polygon";
-            insidePolygonsIndices.push_back(indicesPoliPoi);
-        } else if (isPointInsideConcavePolygon(point, concaveVertices, concaveIndices)){
-            insidePolygonsIndices.push_back(indicesPoliPoi);
+            // here is where we will close the polygon
+            LOG(LogLevel::INFO) << net.getIndex(nodeCreation) << " closing polygon";
+            pieces.defer(std::move(indicesPoli));
+            tasks.push_back(Network::NONE);
+            tasks.push_back(nodeCreation);
         } else{
-            outsidePolygonsIndices.push_back(indicesPoliPoi);
+            LOG(LogLevel::INFO) << net.getIndex(node) << " is already touched";
+            if constexpr (Pieces::SEGMENT_POINTS){
+                LOG(LogLevel::INFO) << "returning to start";
+                const unsigned int arrivedNode = getNextIntersectionAdding(node, *indicesPoli);
+                if (arrivedNode != initialNode){
+                    LOG(LogLevel::WARN) << "arrived node is not initial node";
+                }
+            }
+            pieces.close(std::move(indicesPoli));
         }
+        indicesPoli = nullptr;
     }
 }
@@ -6,13 +6,22 @@
 #include "Logger.h"
 #include "Intersector.h"
 #include "Network.h"
+#include "PointGrid.h"
+#include "PreparedPolygon.h"
+#include "EdgeTree.h"
+#include "Segment.h"
+#include "PolygonSet.h"
 
 
 class Polygon{
 
 public:
     Polygon();
-    Polygon(const std::vector<Vector2f>& _points, const std::vector<unsigned int>& _indices);
+    Polygon(const std::vector<Vector2r>& _points, const std::vector<Index>& _indices);
+    // the polygon uses the points of the pool without copying them, the pool has to live longer than the polygon
+    // intersection points are added at the end of the pool and stay there, so the polygons of an element
+    // cutted one after the other can share it (passing it also as extraPoint), the body of the polygon can not be changed
+    Polygon(std::vector<Vector2r>* pointPool, PolygonView _indices);
     ~Polygon();
 
     Polygon(const Polygon&)                 = delete;
@@ -20,15 +29,21 @@ public:
     Polygon& operator=(const Polygon&)      = delete;
     Polygon& operator=(Polygon&&) noexcept  = delete;
 
-    void setBody(const std::vector<Vector2f>& _points, const std::vector<unsigned int>& _indices);
-    void setSegment(const Vector2f& _p1, const Vector2f& _p2);
+    void setBody(const std::vector<Vector2r>& _points, const std::vector<Index>& _indices);
+    void setSegment(const Vector2r& _p1, const Vector2r& _p2);
 
-    const Vector2f& getPoint(unsigned int index) const;
-    const std::vector<Vector2f>& getPoints() const;
-    const std::vector<unsigned int>& getIndices() const;
-    std::vector<Vector2f> getSegment() const;
+    // nodes are created in this network instead of the one owned by the polygon
+    // the network is cleared every time a network is created and when the polygon is deleted,
+    // so it can be shared by polygons used one after the other but never at the same time
+    void setNetwork(Network* sharedNetwork);
+
+    const Vector2r& getPoint(unsigned int index) const;
+    const std::vector<Vector2r>& getPoints() const;
+    const std::vector<Index>& getIndices() const;
+    std::vector<Vector2r> getSegment() const;
     unsigned int getNumberIndices() const;
-    const Node* getStartNode() const;
+    unsigned int getStartNode() const;
+    const Network& getNetwork() const;
     unsigned int getNumberIntersections() const;
 
     void printVertices              (LogLevel level = LogLevel::INFO) const;
@@ -36,83 +51,206 @@ public:
     void printNetwork               (LogLevel level = LogLevel::INFO) const;
     void printNetworkWithCoordinates(LogLevel level = LogLevel::INFO) const;
 
+    // build an edge tree of the polygon, then createNetwork intersects only the edges near the segment line
+    // it is worth it when the same polygon is cutted by a lot of segments, setBody removes it
+    void createEdgeTree();
+
     void createNetwork(bool addSegmentPoints = false);
 
-    void createNetworkMesh(std::vector<Vector2f>& extraPoint);
+    void createNetworkMesh(std::vector<Vector2r>& extraPoint);
+    // grid has to index extraPoint, which has to contain the same points as the polygon,
+    // new intersection points are added to both so the grid can be used for the next polygon cutted
+    void createNetworkMesh(std::vector<Vector2r>& extraPoint, PointGrid& grid);
 
     void deleteStartNode();
 
-    std::vector<std::shared_ptr<std::vector<unsigned int>>> cut();
+    PolygonSet cut();
 
-    void cutIndices(std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices);
+    // the small polygons are added after the ones already in polygonsIndices
+    void cutIndices(PolygonSet& polygonsIndices);
 
-    void cutInsideOutside(std::vector<std::shared_ptr<std::vector<unsigned int>>>& insideIndices,
-                          std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsideIndices);
+    // the same as cut, but the small polygons replace the ones in polygonsIndices and its memory is used again,
+    // cutting the same polygon with a lot of segments then allocates memory only when a cut has more indices
+    // than all the ones before
+    void cutReusing(PolygonSet& polygonsIndices);
 
-    void cutInsideOutsideConcave(std::vector<std::shared_ptr<std::vector<unsigned int>>>& insideIndices,
-                                 std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsideIndices,
-                                 const std::vector<Vector2f>& concaveVertices, const std::vector<unsigned int>& concaveIndices,
-                                 RelativePosition relativePosition);
+    void cutInsideOutside(PolygonSet& insideIndices,
+                          PolygonSet& outsideIndices);
 
-    float getWidth()  const;
-    float getHeight() const;
-    float getXMin()   const;
-    float getYMin()   const;
+    void cutInsideOutsideConcave(PolygonSet& insideIndices,
+                                 PolygonSet& outsideIndices,
+                                 const std::vector<Vector2r>& concaveVertices, const std::vector<Index>& concaveIndices,
+                                 RelativePosition relativePosition);
+    // the same, with the concave polygon prepared once for all the polygons cutted
+    void cutInsideOutsideConcave(PolygonSet& insideIndices,
+                                 PolygonSet& outsideIndices,
+                                 const PreparedPolygon& concavePolygon, RelativePosition relativePosition);
+
+    // cut the polygon with all the lines at once (a line passes through the two points of the segment)
+    // every piece added to piecesIndices is on one side of each line, its signature has the side of the piece
+    // with respect to every line: Positive on the left, Negative on the right, Parallel only if the piece is on the line
+    // intersection points are added to extraPoint and grid as in createNetworkMesh
+    // with fixedPoint all the points are on the grid of FixedPoint and the intersection points are snapped to it
+    void cutArrangement(const std::vector<Segment>& lines, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                        PolygonSet& piecesIndices,
+                        std::vector<std::vector<RelativePosition>>& signatures, bool fixedPoint = false);
+
+    // clip the polygon with another polygon, the pieces inside the clip polygon go in insideIndices, the others in outsideIndices
+    // the two boundaries meet in points that are added to both, the clip edges inside the polygon cut it in pieces
+    // and a piece is inside if it has one of them on its left in the direction of the clip polygon,
+    // so a point is tested only for a piece that has no clip edge (when the boundaries do not cross)
+    // intersection points are added to extraPoint and grid as in createNetworkMesh, fixedPoint as in cutArrangement
+    void clipInsideOutside(const PreparedPolygon& clipPolygon, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                           PolygonSet& insideIndices,
+                           PolygonSet& outsideIndices, bool fixedPoint = false);
+
+    // cut the polygon with the lines of a convex anti-clockwise border, the pieces on the left of every line
+    // (inside the border) go in insideIndices, the others in outsideIndices, the pieces are the ones of cutArrangement
+    // a convex polygon is split by one line after the other as in Sutherland-Hodgman, but the part on the right
+    // is split by the next lines too so the pieces have the same vertices of the ones of the polygons near
+    // the pieces are kept in flat buffers while they are split, a polygon that is not convex uses cutArrangement
+    // intersection points are added to extraPoint and grid as in createNetworkMesh, fixedPoint as in cutArrangement
+    void cutConvexBorder(const std::vector<Segment>& borderLines, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                         PolygonSet& insideIndices,
+                         PolygonSet& outsideIndices, bool fixedPoint = false);
+
+    Real getWidth()  const;
+    Real getHeight() const;
+    Real getXMin()   const;
+    Real getYMin()   const;
 
     static const double BIG_DOUBLE;
+    // squared distance of two points that are the same in cutArrangement and clipInsideOutside, it is much less than Vector2r::TOLERANCE
+    // so an intersection point is not moved on a vertex of a thin part of the polygon nearby
+    static const double TOLERANCE_ARRANGEMENT;
 
     // this function calculate the polygon area using Gauss
-    static double CalculateArea(const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices);
+    static double CalculateArea(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
     // with default indices
-    static double CalculateArea(const std::vector<Vector2f>& vertices);
+    static double CalculateArea(const std::vector<Vector2r>& vertices);
 
-    static std::vector<Vector2f> translateVertices(const std::vector<Vector2f>& vertices, float diffX, float diffY);
-    static std::shared_ptr<std::vector<Vector2f>> translateVerticesPointer(const std::vector<Vector2f>& vertices, float diffX, float diffY);
+    // return: true if all the turns of the polygon are on the same side (vertices on a line are allowed)
+    // and it goes around once, false for less than 3 vertices or all of them on a line
+    static bool IsConvex(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
+    // with default indices
+    static bool IsConvex(const std::vector<Vector2r>& vertices);
+
+    static std::vector<Vector2r> translateVertices(const std::vector<Vector2r>& vertices, Real diffX, Real diffY);
+    static std::shared_ptr<std::vector<Vector2r>> translateVerticesPointer(const std::vector<Vector2r>& vertices, Real diffX, Real diffY);
 
-    static std::vector<Vector2f> scaleVertices(const std::vector<Vector2f>& vertices,
-                                               float originalWidth, float originalHeight, float newWidth, float newHeight);
+    static std::vector<Vector2r> scaleVertices(const std::vector<Vector2r>& vertices,
+                                               Real originalWidth, Real originalHeight, Real newWidth, Real newHeight);
 
-    static void scaleXYMin(float* const originalXMin, float* const originalYMin,
-                           float originalWidth, float originalHeight, float newWidth, float newHeight);
+    static void scaleXYMin(Real* const originalXMin, Real* const originalYMin,
+                           Real originalWidth, Real originalHeight, Real newWidth, Real newHeight);
 
-    static void createBoundingBoxVariables(const std::vector<Vector2f>& vertices, float& width, float& height, float& xMin, float& yMin);
+    static void createBoundingBoxVariables(const std::vector<Vector2r>& vertices, Real& width, Real& height, Real& xMin, Real& yMin);
+    // with just the vertices of the indices
+    static void createBoundingBoxVariables(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                           Real& width, Real& height, Real& xMin, Real& yMin);
 
-    static bool isPointBoundaryConcavePolygon(const Vector2f& point,
-                                              const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices);
+    static bool isPointBoundaryConcavePolygon(const Vector2r& point,
+                                              const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
 
-    static bool isPointInsideConcavePolygon(const Vector2f& point,
-                                            const std::vector<Vector2f>& vertices, const std::vector<unsigned int>& indices);
+    static bool isPointInsideConcavePolygon(const Vector2r& point,
+                                            const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
 
 private:
-    std::vector<Vector2f> points;
-    std::vector<unsigned int> indices;
-    Node* startNode;
-    Node* firstNode;
+    // points of the polygon when there is no point pool
+    std::vector<Vector2r> ownPoints;
+    // ownPoints or the point pool
+    std::vector<Vector2r>& points;
+    std::vector<Index> indices;
+    // points of the body, createNetwork adds the intersection points after them
+    unsigned int numberBodyPoints;
+    // nullptr if createEdgeTree is not called
+    std::unique_ptr<EdgeTree> edgeTree;
+    Network ownNetwork;
+    // points to ownNetwork if no shared network is set
+    Network* network;
+    unsigned int startNode;
+    unsigned int firstNode;
     RelativePosition orientation;
-    Vector2f p1;
-    Vector2f p2;
+    Vector2r p1;
+    Vector2r p2;
     unsigned int numberIntersections;
 
-    float width;
-    float height;
-    float xMin;
-    float yMin;
+    Real width;
+    Real height;
+    Real xMin;
+    Real yMin;
 
     bool alsoSegmentPoints;
 
+    // memory used by every cut, it is kept by the polygon so cutting it again with another segment
+    // uses the memory of the cut before (the nodes are kept by the network in the same way)
+    struct CutWorkspace{
+        // edges of the body, made for the first segment when there is no edge tree
+        EdgeArrays bodyEdges;
+        // body prepared for the point queries of addSegmentPointsToNetwork, made for the first segment that needs it
+        std::unique_ptr<PreparedPolygon> preparedBody;
+        PreparedPolygon::QueryBuffers queryBuffers;
+        // edges near the segment line when there is an edge tree, and the stack used to find them
+        std::vector<unsigned int> nearEdges;
+        std::vector<unsigned int> treeStack;
+        EdgeArrays nearEdgeArrays;
+        std::vector<LineSegmentIntersection> nearTypes;
+        std::vector<Vector2r> nearPoints;
+        // intersection with every edge
+        std::vector<LineSegmentIntersection> intersectionTypes;
+        std::vector<Vector2r> intersectionPoints;
+        std::vector<unsigned int> unorderedIntersectionNodes;
+        std::vector<unsigned int> possibleOnVertex;
+        // product with the segment and position of every intersection node, used to sort them
+        std::vector<std::pair<double, unsigned int>> products;
+        // tasks of cutSmallPolygons
+        std::vector<unsigned int> tasks;
+        // small polygons of cutInsideOutsideConcave not closed yet, the last one is always closed first
+        PolygonSet openPieces;
+    };
+    CutWorkspace workspace;
+
+    // return: true if the points are the ones of a point pool
+    bool hasPointPool() const;
+
     // simply check if the number of points and indices is greater than 1
     void checkEnoughPointIndices() const;
 
-    bool checkIsPointIntersection(const Node* node) const;
+    // return: true if the segment line passes far enough from the bounding box that no edge can be intersected
+    bool isSegmentLineAwayFromBox() const;
+
+    bool checkIsPointIntersection(unsigned int node) const;
+
+    // intersection of the segment line (segment 1 of inter) with every edge, with the edge tree if there is one
+    void calculateEdgeIntersections(const Intersector& inter, std::vector<LineSegmentIntersection>& types,
+                                    std::vector<Vector2r>& intersectionPoints);
+
+    // indices in anti-clockwise order and their bounding box
+    void calculateBoundaryAntiClockwise(std::vector<Index>& boundary,
+                                        Real& boxXMin, Real& boxYMin, Real& boxXMax, Real& boxYMax) const;
+
+    // return: index of the point, a new one is added to points, extraPoint and grid if it is not already there
+    unsigned int findOrAddPoint(const Vector2r& point, std::vector<Vector2r>& extraPoint, PointGrid& grid,
+                                double tolerance = Vector2r::TOLERANCE);
+
+    // even-odd test, the point must not be on the boundary
+    static bool IsPointInsideSimplePolygon(const Vector2r& point,
+                                           const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
+
+    // faces inside the planar graph made by the anti-clockwise boundary and the chords inside it
+    // every face is walked keeping it on the left, turning at every vertex on the first edge clockwise
+    static void TraceFaces(const std::vector<Vector2r>& vertices, const std::vector<Index>& boundary,
+                           const std::vector<std::pair<unsigned int, unsigned int>>& chords,
+                           PolygonSet& faces);
 
     // return a node from where it can be calculated inside/outside concave polygon,
     // return the same node as input if all points are on boundary
-    const Node* getNodeNotBoundary(const Node* node);
+    unsigned int getNodeNotBoundary(unsigned int node);
 
     void addSegmentPointsToNetwork();
 
-    const Node* getNextNotBetween(const Node* node, bool upDirection);
-    const Node* getNextNotBetween(const Node* node, bool upDirection, std::vector<unsigned int>& indicesPoli);
+    unsigned int getNextNotBetween(unsigned int node, bool upDirection);
+    unsigned int getNextNotBetween(unsigned int node, bool upDirection, PolygonSet& indicesPoli);
 
     // this function calculate the relative orientation of the polygon with the segment
     // it is used in getNextIntersection to, given an intersection node, find wich one of the two intersection nodes closer (up and down)
@@ -121,37 +259,47 @@ private:
     //RelativePosition calculateOrientationFromNode(Node* node);
 
     // as stated before, this function only takes intersection nodes as input
-    const Node* getNextIntersection(const Node* node);
+    unsigned int getNextIntersection(unsigned int node);
 
-    const Node* getNextIntersectionAdding(const Node* node, std::vector<unsigned int>& indicesPoli);
+    unsigned int getNextIntersectionAdding(unsigned int node, PolygonSet& indicesPoli);
 
     // this function is used to order the intersection nodes, from the one the segment touches last to the one it touches first
-    void sortIntersectionsNetwork(const std::vector<Node*>& nodes);
-
-    // this is the function that will be recursively called when cutting the polygon
-    // the first parameter is the node we currently are at when cutting the polygon
-    // the second parameter is the initial node of the small polygon we are considering
-    // node == initialNode if we are creating a new small polygon (maby the function name should be changed)
-    // relative position here is different from the RelativePosition used in orientation
-    // this one specify if the small polygon is above or below the segment, obiously is relative,
-    // but if always the same convention is applied it works
-    // the fourth paramter is a reference to the particular set of indices of the small polygon, empty if the small polygon is just created
-    // the last one is the reference to the array of indices of all small polygon, so when a new small polygon is created
-    // we can add his new array of indices to the big array of arrays
-    void continueSmallPolygon(const Node* node, const Node* initialNode, std::vector<unsigned int>& indicesPoli,
-                              std::vector<std::shared_ptr<std::vector<unsigned int>>>& polygonsIndices);
-
-    // this is the same but is used when we want to distinguish between polygons up or below segment
-    void continueSmallPolygonInsideOutside(const Node* node, const Node* initialNode,
-        std::shared_ptr<std::vector<unsigned int>> indicesPoliPoi,
-        std::vector<std::shared_ptr<std::vector<unsigned int>>>& insidePolygonsIndices,
-        std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsidePolygonsIndices);
-
-    void continueSmallPolygonInsideOutsideConcave(const Node* node, const Node* initialNode,
-        std::shared_ptr<std::vector<unsigned int>> indicesPoliPoi,
-        std::vector<std::shared_ptr<std::vector<unsigned int>>>& insidePolygonsIndices,
-        std::vector<std::shared_ptr<std::vector<unsigned int>>>& outsidePolygonsIndices,
-        const std::vector<Vector2f>& concaveVertices, const std::vector<unsigned int>& concaveIndices);
+    void sortIntersectionsNetwork(const std::vector<unsigned int>& nodes);
+
+    // adds to the small polygon (the last one of indicesPoli) the node we are at and the nodes after it up to the next intersection node
+    // (or up to the initial node of the small polygon), return: the node where it stops
+    unsigned int addNodesUntilIntersection(unsigned int node, unsigned int initialNode, PolygonSet& indicesPoli);
+
+    // the network builder and the cut are templates on a policy, so every mode is compiled on its own
+    // without checking the mode inside the loops, and a new mode is only a new policy
+    // point policies say what an intersection point is and how the network is finished:
+    // SEGMENT_POINTS: the points of the segment inside the polygon are added to the network (and to the small polygons)
+    // ANTI_CLOCKWISE: the indices are anti-clockwise so the orientation is not calculated,
+    // and one intersection is a segment tangent to the polygon
+    // addPoint(polygon, point) returns the index of the intersection point
+    template<bool addSegmentPoints> struct NewPoints;
+    struct SharedPoints;
+
+    template<typename PointPolicy>
+    void buildNetwork(PointPolicy& pointPolicy);
+
+    // pieces policies say where the small polygons go:
+    // create(node) returns the indices of a new small polygon starting from the node, nullptr if it is not created
+    // close(piece) is called when the small polygon is finished, SEGMENT_POINTS as in the point policies
+    template<bool addSegmentPoints> struct PlainPieces;
+    struct InsideOutsidePieces;
+    struct ConcavePieces;
+
+    // this is the function that cuts the polygon in small polygons, starting from the start node
+    // at every intersection node the small polygon we are creating continues with getNextIntersection
+    // and a new small polygon has to be created from the intersection node when it is finished
+    // these nodes are kept in a stack, the last one added is created first, so a polygon with a lot of intersections
+    // does not use more call stack than one with a few
+    template<typename Pieces>
+    void cutSmallPolygons(unsigned int startNode, Pieces& pieces);
+
+    // cut with all the small polygons added to polygonsIndices
+    void cutPlain(PolygonSet& polygonsIndices);
 };
 
 #endif //POLYGON_H
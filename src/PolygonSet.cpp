@@ -0,0 +1,81 @@
+#include "PolygonSet.h"
+#include <algorithm>
+#include <functional>
+
+std::vector<Index> PolygonView::toVector() const{
+    return std::vector<Index>(begin(), end());
+}
+
+bool PolygonView::operator==(const PolygonView& other) const{
+    return count == other.count && std::equal(begin(), end(), other.begin());
+}
+
+bool PolygonView::operator!=(const PolygonView& other) const{
+    return !(*this == other);
+}
+
+PolygonSet::PolygonSet() : offsets{0} {}
+
+PolygonSet::PolygonSet(PolygonView polygon) : offsets{0} {
+    addPolygon(polygon);
+}
+
+const std::vector<unsigned int>& PolygonSet::getOffsets() const{
+    return offsets;
+}
+
+const std::vector<Index>& PolygonSet::getIndices() const{
+    return indices;
+}
+
+void PolygonSet::clear(){
+    offsets.resize(1);
+    indices.clear();
+}
+
+void PolygonSet::reserve(unsigned int numberPolygons, unsigned int numberIndices){
+    offsets.reserve(numberPolygons + 1);
+    indices.reserve(numberIndices);
+}
+
+void PolygonSet::removeLastPolygon(){
+    if (empty()){
+        return;
+    }
+    offsets.pop_back();
+    indices.resize(offsets.back());
+}
+
+void PolygonSet::addPolygon(PolygonView polygon){
+    // the view can look at this set, it is copied before the indices can move
+    const std::less<const Index*> before;
+    if (!before(polygon.data(), indices.data()) && before(polygon.data(), indices.data() + indices.size())){
+        const std::vector<Index> copy = polygon.toVector();
+        addPolygon(copy);
+        return;
+    }
+    indices.insert(indices.end(), polygon.begin(), polygon.end());
+    offsets.push_back(indices.size());
+}
+
+void PolygonSet::append(const PolygonSet& other){
+    if (&other == this){
+        const PolygonSet copy(other);
+        append(copy);
+        return;
+    }
+    const unsigned int shift = indices.size();
+    const unsigned int numberOther = other.size();
+    indices.insert(indices.end(), other.indices.begin(), other.indices.end());
+    for (unsigned int i = 1; i <= numberOther; i++){
+        offsets.push_back(shift + other.offsets[i]);
+    }
+}
+
+bool PolygonSet::operator==(const PolygonSet& other) const{
+    return offsets == other.offsets && indices == other.indices;
+}
+
+bool PolygonSet::operator!=(const PolygonSet& other) const{
+    return !(*this == other);
+}
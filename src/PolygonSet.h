@@ -0,0 +1,118 @@
+#ifndef POLYGONSET_H
+#define POLYGONSET_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <limits>
+
+// the indices of the points are stored in Index, 32 bits by default and 16 when the library is built with
+// -DPOLYGON_INDEX_BITS=16: the small polygons take half of the memory, but an element (or polygon) can have
+// at most 65536 points, also counting the points added when it is cutted
+#if defined(POLYGON_INDEX_BITS) && POLYGON_INDEX_BITS == 16
+using Index = uint16_t;
+#else
+using Index = uint32_t;
+#endif
+
+// indices of one polygon, they are not copied: the view is valid until the set (or vector) it looks at is changed
+class PolygonView{
+
+public:
+    PolygonView() : first{nullptr}, count{0} {}
+    PolygonView(const Index* _first, unsigned int _count) : first{_first}, count{_count} {}
+    // every vector of indices is a polygon, so the functions that take a view take a vector too
+    PolygonView(const std::vector<Index>& _indices) : first{_indices.data()}, count{(unsigned int)_indices.size()} {}
+
+    const Index* begin() const { return first; }
+    const Index* end() const { return first + count; }
+    const Index* data() const { return first; }
+    unsigned int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Index operator[](unsigned int i) const { return first[i]; }
+
+    std::vector<Index> toVector() const;
+
+    bool operator==(const PolygonView& other) const;
+    bool operator!=(const PolygonView& other) const;
+
+private:
+    const Index* first;
+    unsigned int count;
+};
+
+// small polygons one after the other in a single array: polygon i has the indices from offsets[i] up to offsets[i + 1]
+// all the polygons of a cut are two allocations instead of one (and a reference count) for each polygon,
+// they are iterated in order in memory and written to a file or copied as two arrays
+class PolygonSet{
+
+public:
+    PolygonSet();
+
+    // every index of a point fits in Index, so an element (or polygon) has at most this number of points
+    static constexpr uint64_t MAX_NUMBER_POINTS = (uint64_t)std::numeric_limits<Index>::max() + 1;
+    // set with just this polygon
+    explicit PolygonSet(PolygonView polygon);
+
+    unsigned int size() const { return offsets.size() - 1; }
+    bool empty() const { return offsets.size() == 1; }
+    unsigned int getNumberIndices() const { return indices.size(); }
+
+    PolygonView operator[](unsigned int i) const {
+        return PolygonView(indices.data() + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    PolygonView back() const { return (*this)[size() - 1]; }
+
+    // offsets has size() + 1 elements, the first is 0 and the last is the number of indices
+    const std::vector<unsigned int>& getOffsets() const;
+    const std::vector<Index>& getIndices() const;
+
+    void clear();
+    void reserve(unsigned int numberPolygons, unsigned int numberIndices);
+
+    // a polygon is built adding a new empty polygon at the end and then its indices one by one
+    void startPolygon() { offsets.push_back(indices.size()); }
+    void addIndex(Index index) {
+        indices.push_back(index);
+        offsets.back()++;
+    }
+    // the last polygon is removed, for example when it has no area
+    void removeLastPolygon();
+
+    void addPolygon(PolygonView polygon);
+    // the polygons of other are added after the ones of this set
+    void append(const PolygonSet& other);
+
+    class Iterator{
+    public:
+        Iterator(const PolygonSet* _set, unsigned int _position) : set{_set}, position{_position} {}
+        PolygonView operator*() const { return (*set)[position]; }
+        Iterator& operator++() {
+            position++;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return position != other.position; }
+    private:
+        const PolygonSet* set;
+        unsigned int position;
+    };
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, size()); }
+
+    bool operator==(const PolygonSet& other) const;
+    bool operator!=(const PolygonSet& other) const;
+
+private:
+    std::vector<unsigned int> offsets;
+    std::vector<Index> indices;
+};
+
+// small polygons of a cutted mesh element, inside and outside the border
+// the sets of an element the border does not touch are shared by all the elements in the same position
+struct IndicesElement{
+    std::shared_ptr<const PolygonSet> indicesInside;
+    std::shared_ptr<const PolygonSet> indicesOutside;
+};
+
+#endif // POLYGONSET_H
@@ -0,0 +1,203 @@
+#include "PolygonValidator.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <set>
+
+// return: true if a comes before b going from left to right, and from bottom to top on the same x
+static bool IsPointBefore(const Vector2r& a, const Vector2r& b){
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+std::ostream& operator<<(std::ostream& ostream, const PolygonDefect& defect){
+    if (defect == PolygonDefect::None){
+        ostream << "None";
+    } else if (defect == PolygonDefect::TooFewVertices){
+        ostream << "Too few vertices";
+    } else if (defect == PolygonDefect::IndexOutOfRange){
+        ostream << "Index out of range";
+    } else if (defect == PolygonDefect::ZeroLengthEdge){
+        ostream << "Zero length edge";
+    } else if (defect == PolygonDefect::CrossingEdges){
+        ostream << "Crossing edges";
+    }
+    return ostream;
+}
+
+PolygonDefect PolygonValidator::FindDefect(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                           unsigned int& firstEdge, unsigned int& secondEdge){
+    const unsigned int numberEdges = indices.size();
+    firstEdge = 0;
+    secondEdge = 0;
+    if (numberEdges < 3){
+        return PolygonDefect::TooFewVertices;
+    }
+    for (unsigned int i = 0; i < numberEdges; i++){
+        if (indices[i] >= vertices.size()){
+            firstEdge = i;
+            secondEdge = i;
+            return PolygonDefect::IndexOutOfRange;
+        }
+    }
+
+    // a point that is the vertex of two edges that are not consecutive touches the polygon twice,
+    // the sweep does not look for it because edges that end in a point are removed before the ones that start in it
+    std::vector<unsigned int> byPoint(numberEdges);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        byPoint[i] = i;
+    }
+    std::sort(byPoint.begin(), byPoint.end(), [&vertices, &indices](unsigned int a, unsigned int b){
+        const Vector2r& pointA = vertices[indices[a]];
+        const Vector2r& pointB = vertices[indices[b]];
+        return IsPointBefore(pointA, pointB) || (pointA == pointB && a < b);
+    });
+    for (unsigned int i = 0; i + 1 < numberEdges; i++){
+        if (vertices[indices[byPoint[i]]] == vertices[indices[byPoint[i + 1]]]){
+            const unsigned int first = byPoint[i];
+            const unsigned int second = byPoint[i + 1];
+            if (second == first + 1 || (first == 0 && second == numberEdges - 1)){
+                // the edge between them has no length
+                firstEdge = second == first + 1 ? first : second;
+                secondEdge = firstEdge;
+                return PolygonDefect::ZeroLengthEdge;
+            }
+            firstEdge = first;
+            secondEdge = second;
+            return PolygonDefect::CrossingEdges;
+        }
+    }
+
+    // every edge from its left point to its right one
+    std::vector<Vector2r> leftPoints(numberEdges);
+    std::vector<Vector2r> rightPoints(numberEdges);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        const Vector2r& first = vertices[indices[i]];
+        const Vector2r& second = vertices[indices[(i + 1) % numberEdges]];
+        const bool firstBefore = IsPointBefore(first, second);
+        leftPoints[i] = firstBefore ? first : second;
+        rightPoints[i] = firstBefore ? second : first;
+    }
+
+    // the edge of an event starts in the event point or ends in it, in the same point the edges
+    // that end are removed first so that two consecutive edges on the same line are never in the set together
+    struct Event{
+        unsigned int edge;
+        bool start;
+    };
+    std::vector<Event> events;
+    events.reserve(2 * numberEdges);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        events.push_back({i, true});
+        events.push_back({i, false});
+    }
+    std::sort(events.begin(), events.end(), [&leftPoints, &rightPoints](const Event& a, const Event& b){
+        const Vector2r& pointA = a.start ? leftPoints[a.edge] : rightPoints[a.edge];
+        const Vector2r& pointB = b.start ? leftPoints[b.edge] : rightPoints[b.edge];
+        if (IsPointBefore(pointA, pointB)){
+            return true;
+        }
+        if (IsPointBefore(pointB, pointA)){
+            return false;
+        }
+        return !a.start && b.start;
+    });
+
+    // edges crossed by the sweep line from bottom to top, the edges in the set do not cross each other,
+    // so the one that starts later is on the same side of the other one in every point they share on the x axis
+    auto isBelow = [&leftPoints, &rightPoints](unsigned int a, unsigned int b){
+        if (!IsPointBefore(leftPoints[b], leftPoints[a])){
+            int side = Predicates::Orient2d(leftPoints[a], rightPoints[a], leftPoints[b]);
+            if (side == 0){
+                side = Predicates::Orient2d(leftPoints[a], rightPoints[a], rightPoints[b]);
+            }
+            return side > 0;
+        }
+        int side = Predicates::Orient2d(leftPoints[b], rightPoints[b], leftPoints[a]);
+        if (side == 0){
+            side = Predicates::Orient2d(leftPoints[b], rightPoints[b], rightPoints[a]);
+        }
+        return side < 0;
+    };
+    std::set<unsigned int, decltype(isBelow)> sweep(isBelow);
+
+    for (const Event& event : events){
+        if (event.start){
+            auto [position, inserted] = sweep.insert(event.edge);
+            if (!inserted){
+                // an edge on the same line and over the same points is already there
+                firstEdge = std::min(*position, event.edge);
+                secondEdge = std::max(*position, event.edge);
+                return PolygonDefect::CrossingEdges;
+            }
+            auto above = std::next(position);
+            if (above != sweep.end() && AreEdgesCrossing(vertices, indices, event.edge, *above)){
+                firstEdge = std::min(*above, event.edge);
+                secondEdge = std::max(*above, event.edge);
+                return PolygonDefect::CrossingEdges;
+            }
+            if (position != sweep.begin()){
+                auto below = std::prev(position);
+                if (AreEdgesCrossing(vertices, indices, event.edge, *below)){
+                    firstEdge = std::min(*below, event.edge);
+                    secondEdge = std::max(*below, event.edge);
+                    return PolygonDefect::CrossingEdges;
+                }
+            }
+        } else{
+            auto position = sweep.find(event.edge);
+            if (position == sweep.end()){
+                continue;
+            }
+            // the edges below and above become neighbours
+            auto above = std::next(position);
+            if (position != sweep.begin() && above != sweep.end()){
+                auto below = std::prev(position);
+                if (AreEdgesCrossing(vertices, indices, *below, *above)){
+                    firstEdge = std::min(*below, *above);
+                    secondEdge = std::max(*below, *above);
+                    return PolygonDefect::CrossingEdges;
+                }
+            }
+            sweep.erase(position);
+        }
+    }
+    return PolygonDefect::None;
+}
+
+bool PolygonValidator::IsSimple(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices){
+    unsigned int firstEdge;
+    unsigned int secondEdge;
+    return FindDefect(vertices, indices, firstEdge, secondEdge) == PolygonDefect::None;
+}
+
+bool PolygonValidator::AreEdgesCrossing(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                        unsigned int first, unsigned int second){
+    const unsigned int numberEdges = indices.size();
+    const Vector2r& a = vertices[indices[first]];
+    const Vector2r& b = vertices[indices[(first + 1) % numberEdges]];
+    const Vector2r& c = vertices[indices[second]];
+    const Vector2r& d = vertices[indices[(second + 1) % numberEdges]];
+
+    // consecutive edges share a vertex, they cross only if they go back on the same line
+    if (second == (first + 1) % numberEdges){
+        return Predicates::Orient2d(b, a, d) == 0 && IsPointBefore(b, a) == IsPointBefore(b, d);
+    }
+    if (first == (second + 1) % numberEdges){
+        return Predicates::Orient2d(a, b, c) == 0 && IsPointBefore(a, b) == IsPointBefore(a, c);
+    }
+
+    const int sideC = Predicates::Orient2d(a, b, c);
+    const int sideD = Predicates::Orient2d(a, b, d);
+    const int sideA = Predicates::Orient2d(c, d, a);
+    const int sideB = Predicates::Orient2d(c, d, b);
+    if (sideC * sideD < 0 && sideA * sideB < 0){
+        return true;
+    }
+    return (sideC == 0 && IsOnSegment(a, b, c)) || (sideD == 0 && IsOnSegment(a, b, d)) ||
+           (sideA == 0 && IsOnSegment(c, d, a)) || (sideB == 0 && IsOnSegment(c, d, b));
+}
+
+bool PolygonValidator::IsOnSegment(const Vector2r& first, const Vector2r& second, const Vector2r& point){
+    const Vector2r& left = IsPointBefore(first, second) ? first : second;
+    const Vector2r& right = IsPointBefore(first, second) ? second : first;
+    return !IsPointBefore(point, left) && !IsPointBefore(right, point);
+}
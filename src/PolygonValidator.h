@@ -0,0 +1,54 @@
+#ifndef POLYGONVALIDATOR_H
+#define POLYGONVALIDATOR_H
+
+#include <vector>
+#include <iostream>
+#include "Vector2.h"
+#include "PolygonSet.h"
+
+
+enum class PolygonDefect{
+    None                = 0,
+    TooFewVertices      = 1,
+    IndexOutOfRange     = 2,
+    // two consecutive vertices are the same point
+    ZeroLengthEdge      = 3,
+    // two edges have a point in common that is not the vertex between two consecutive edges
+    CrossingEdges       = 4
+};
+
+std::ostream& operator<<(std::ostream& ostream, const PolygonDefect& defect);
+
+// checks that a polygon is simple before it is cut, a polygon that crosses itself ends deep inside Polygon::cut
+// with odd intersections or traversals that do not close
+// the check is the sweep line of Shamos and Hoey: the edges are sorted by their leftmost point and kept in a set
+// ordered from bottom to top while the line moves, only edges that become neighbours in the set are tested,
+// so the first crossing is found in O(n log n) instead of testing every pair of edges
+// every test uses the exact predicates, a vertex that touches another edge is a crossing too
+class PolygonValidator{
+
+public:
+    PolygonValidator()                                      = delete;
+    PolygonValidator(const PolygonValidator&)               = delete;
+    PolygonValidator(PolygonValidator&&) noexcept           = delete;
+    PolygonValidator& operator=(const PolygonValidator&)    = delete;
+    PolygonValidator& operator=(PolygonValidator&&) noexcept= delete;
+
+    // edge i goes from the vertex of index i to the next one, as in Intersector::CreateEdgeArrays
+    // return: the first defect found, firstEdge and secondEdge are the edges with it
+    // (the same edge for ZeroLengthEdge, the position of the wrong index for IndexOutOfRange)
+    static PolygonDefect FindDefect(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                    unsigned int& firstEdge, unsigned int& secondEdge);
+
+    static bool IsSimple(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices);
+
+private:
+    // return: true if the two edges have a point in common they are not allowed to have
+    static bool AreEdgesCrossing(const std::vector<Vector2r>& vertices, const std::vector<Index>& indices,
+                                 unsigned int first, unsigned int second);
+
+    // return: true if point, known to be on the line of the segment, is inside it or on one of its vertices
+    static bool IsOnSegment(const Vector2r& first, const Vector2r& second, const Vector2r& point);
+};
+
+#endif // POLYGONVALIDATOR_H
@@ -0,0 +1,157 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include "Vector2.h"
+#include "Intersector.h"
+#include "FixedPoint.h"
+#include <type_traits>
+
+
+// geometric predicates that always give the right sign, they do not use any tolerance
+// every function first computes the result in double with an error bound (Shewchuk's orient2d filter)
+// and only when the result is smaller than the bound it is computed again exactly
+// the exact part works because the product of two floats fits in a double, so the determinant is a sum of eight
+// exact products that is added up without losing anything in a small expansion on the stack, nothing is allocated
+// in double precision every product is split in two doubles (Dekker's product) and the expansion has sixteen
+// points on the grid of FixedPoint skip the expansion, their determinant is exact in int64
+class Predicates{
+
+public:
+    Predicates()                                = delete;
+    Predicates(const Predicates&)               = delete;
+    Predicates(Predicates&&) noexcept           = delete;
+    Predicates& operator=(const Predicates&)    = delete;
+    Predicates& operator=(Predicates&&) noexcept= delete;
+
+    // half of the distance between 1 and the next double
+    static constexpr double EPSILON = 1.1102230246251565e-16;
+    // the sign of the determinant of Cross computed in double is right if it is greater than
+    // ERROR_BOUND_CROSS times the sum of the absolute values of its two products (used by Intersector::CalculateSides)
+    static constexpr double ERROR_BOUND_CROSS = (3.0 + 16.0 * EPSILON) * EPSILON;
+
+    // return: 1 if (b - a) x (d - c) is positive, -1 if it is negative, 0 if the two vectors are parallel
+    static constexpr int Cross(Real ax, Real ay, Real bx, Real by, Real cx, Real cy, Real dx, Real dy){
+        const double detLeft = ((double)bx - ax) * ((double)dy - cy);
+        const double detRight = ((double)by - ay) * ((double)dx - cx);
+        const double det = detLeft - detRight;
+        const double detSum = Abs(detLeft) + Abs(detRight);
+        if (det > ERROR_BOUND_CROSS * detSum){
+            return 1;
+        }
+        if (-det > ERROR_BOUND_CROSS * detSum){
+            return -1;
+        }
+        // the points of the fixed point grid do not need the expansion
+        if (FixedPoint::AreOnGrid(ax, ay, bx, by, cx, cy, dx, dy)){
+            return FixedPoint::Cross(ax, ay, bx, by, cx, cy, dx, dy);
+        }
+        return CrossExact(ax, ay, bx, by, cx, cy, dx, dy);
+    }
+
+    // return: 1 if a, b, c turn counterclockwise, -1 if they turn clockwise, 0 if they are on the same line
+    static constexpr int Orient2d(Real ax, Real ay, Real bx, Real by, Real cx, Real cy){
+        return Cross(ax, ay, bx, by, ax, ay, cx, cy);
+    }
+
+    static int Cross(const Vector2r& a, const Vector2r& b, const Vector2r& c, const Vector2r& d){
+        return Cross(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+    }
+
+    static int Orient2d(const Vector2r& a, const Vector2r& b, const Vector2r& c){
+        return Orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+    }
+
+    // the same as Intersector::calculateRelativePosition with segment 1 from r1 to r2 and segment 2 from s1 to s2
+    // but without tolerance, it is Parallel only when the two segments are exactly parallel
+    static RelativePosition CalculateRelativePosition(const Vector2r& r1, const Vector2r& r2,
+                                                      const Vector2r& s1, const Vector2r& s2){
+        const int sign = Cross(r1, r2, s1, s2);
+        if (sign > 0){
+            return RelativePosition::Positive;
+        }
+        if (sign < 0){
+            return RelativePosition::Negative;
+        }
+        return RelativePosition::Parallel;
+    }
+
+    // return: true if the segments cross in a point that is inside both of them
+    // touching at a vertex or lying on the same line is not a crossing
+    static constexpr bool SegmentsCross(Real ax, Real ay, Real bx, Real by,
+                                        Real cx, Real cy, Real dx, Real dy){
+        const int c = Orient2d(ax, ay, bx, by, cx, cy);
+        const int d = Orient2d(ax, ay, bx, by, dx, dy);
+        if (c == 0 || d == 0 || c == d){
+            return false;
+        }
+        const int a = Orient2d(cx, cy, dx, dy, ax, ay);
+        const int b = Orient2d(cx, cy, dx, dy, bx, by);
+        return a != 0 && b != 0 && a != b;
+    }
+
+    static bool SegmentsCross(const Vector2r& a, const Vector2r& b, const Vector2r& c, const Vector2r& d){
+        return SegmentsCross(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+    }
+
+private:
+    static constexpr double Abs(double a){
+        return a < 0.0 ? -a : a;
+    }
+
+    // return: the error of product = a * b, a * b is exactly product + error
+    // the two factors are split in halves of 26 bits whose products are exact (Dekker's two product)
+    static constexpr double ProductError(double a, double b, double product){
+        const double splitter = 134217729.0;
+        const double bigA = splitter * a;
+        const double highA = bigA - (bigA - a);
+        const double lowA = a - highA;
+        const double bigB = splitter * b;
+        const double highB = bigB - (bigB - b);
+        const double lowB = b - highB;
+        return lowA * lowB - (((product - highA * highB) - lowA * highB) - highA * lowB);
+    }
+
+    static constexpr int CrossExact(Real ax, Real ay, Real bx, Real by, Real cx, Real cy, Real dx, Real dy){
+        // (b - a) x (d - c) expanded, every product of two floats is exact in double
+        const double left[8] = {bx, -bx, -ax, ax, -by, by, ay, -ay};
+        const double right[8] = {dy, cy, dy, cy, dx, cx, dx, cx};
+        double products[16] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        unsigned int numberProducts = 0;
+        for (unsigned int p = 0; p < 8; p++){
+            products[numberProducts] = left[p] * right[p];
+            numberProducts++;
+            if constexpr (!std::is_same<Real, float>::value){
+                // the product of two doubles is rounded, what is lost is added as another component
+                products[numberProducts] = ProductError(left[p], right[p], products[numberProducts - 1]);
+                numberProducts++;
+            }
+        }
+        // nonoverlapping expansion ordered by magnitude, its sign is the sign of the biggest non zero component
+        double expansion[16] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        unsigned int length = 0;
+        for (unsigned int p = 0; p < numberProducts; p++){
+            double q = products[p];
+            for (unsigned int i = 0; i < length; i++){
+                // two sum, sum + error is exactly q + expansion[i]
+                const double sum = q + expansion[i];
+                const double virtualB = sum - q;
+                const double virtualA = sum - virtualB;
+                expansion[i] = (q - virtualA) + (expansion[i] - virtualB);
+                q = sum;
+            }
+            expansion[length] = q;
+            length++;
+        }
+        for (unsigned int i = length; i > 0; i--){
+            if (expansion[i - 1] > 0.0){
+                return 1;
+            }
+            if (expansion[i - 1] < 0.0){
+                return -1;
+            }
+        }
+        return 0;
+    }
+};
+
+#endif // PREDICATES_H
@@ -0,0 +1,370 @@
+#include "PreparedPolygon.h"
+#include "Logger.h"
+#include "Predicates.h"
+#include <math.h>
+#include <algorithm>
+
+PreparedPolygon::PreparedPolygon() : counterclockwise{true}, xMin{0.0}, yMin{0.0}, xMax{0.0}, yMax{0.0},
+                                     numberCellsX{1}, numberCellsY{1}, cellWidth{1.0}, cellHeight{1.0},
+                                     cellStart{0, 0} {}
+
+PreparedPolygon::PreparedPolygon(const std::vector<Vector2r>& _vertices, const std::vector<Index>& _indices) :
+    PreparedPolygon() {
+
+    build(_vertices, _indices);
+}
+
+void PreparedPolygon::build(const std::vector<Vector2r>& _vertices, const std::vector<Index>& _indices){
+    vertices = _vertices;
+    indices = _indices;
+    Intersector::CreateEdgeArrays(vertices, indices, edges);
+
+    const unsigned int numberEdges = getNumberEdges();
+    double doubleArea = 0.0;
+    for (unsigned int i = 0; i < numberEdges; i++){
+        doubleArea += (double)edges.x1[i] * edges.y2[i] - (double)edges.x2[i] * edges.y1[i];
+    }
+    counterclockwise = doubleArea >= 0.0;
+
+    numberCellsX = 1;
+    numberCellsY = 1;
+    cellStart.assign(2, 0);
+    cellEdges.clear();
+    if (numberEdges == 0){
+        xMin = yMin = xMax = yMax = 0.0;
+        cellWidth = cellHeight = 1.0;
+        return;
+    }
+
+    // every edge is grown by its margin, the bounding box is the one of the grown edges
+    std::vector<double> margins(numberEdges);
+    double averageMargin = 0.0;
+    xMin = yMin = INFINITY;
+    xMax = yMax = -INFINITY;
+    for (unsigned int i = 0; i < numberEdges; i++){
+        margins[i] = GetMargin({edges.x1[i], edges.y1[i]}, {edges.x2[i], edges.y2[i]});
+        averageMargin += margins[i] / numberEdges;
+        xMin = std::min(xMin, std::min(edges.x1[i], edges.x2[i]) - margins[i]);
+        yMin = std::min(yMin, std::min(edges.y1[i], edges.y2[i]) - margins[i]);
+        xMax = std::max(xMax, std::max(edges.x1[i], edges.x2[i]) + margins[i]);
+        yMax = std::max(yMax, std::max(edges.y1[i], edges.y2[i]) + margins[i]);
+    }
+
+    // about CELLS_PER_EDGE cells for each edge, square if the bounding box is
+    // cells are not smaller than twice the average margin, or every edge would be in a lot of them
+    // (the margins do not scale with the polygon, small polygons get just a few cells)
+    const double width = xMax - xMin;
+    const double height = yMax - yMin;
+    const double numberCells = std::max(1.0, numberEdges * PreparedPolygon::CELLS_PER_EDGE);
+    const double maximumCellsX = std::max(1.0, floor(width / (2.0 * averageMargin)));
+    const double maximumCellsY = std::max(1.0, floor(height / (2.0 * averageMargin)));
+    numberCellsX = (unsigned int)std::max(1.0, std::min(maximumCellsX, ceil(sqrt(numberCells * width / height))));
+    numberCellsY = (unsigned int)std::max(1.0, std::min(maximumCellsY, ceil(numberCells / numberCellsX)));
+    cellWidth = width / numberCellsX;
+    cellHeight = height / numberCellsY;
+
+    // first the edges of every cell are counted, then they are written one cell after the other
+    // an edge is in every cell it passes less than its margin away from
+    cellStart.assign(numberCellsX * numberCellsY + 1, 0);
+    std::vector<std::vector<unsigned int>> cellsEdge(numberEdges);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        getCells(edges.x1[i], edges.y1[i], edges.x2[i], edges.y2[i], margins[i], cellsEdge[i]);
+        for (unsigned int c : cellsEdge[i]){
+            cellStart[c + 1]++;
+        }
+    }
+    for (unsigned int c = 0; c < numberCellsX * numberCellsY; c++){
+        cellStart[c + 1] += cellStart[c];
+    }
+    cellEdges.resize(cellStart[numberCellsX * numberCellsY]);
+    std::vector<unsigned int> filled(cellStart.begin(), cellStart.end() - 1);
+    for (unsigned int i = 0; i < numberEdges; i++){
+        for (unsigned int c : cellsEdge[i]){
+            cellEdges[filled[c]] = i;
+            filled[c]++;
+        }
+    }
+}
+
+const std::vector<Vector2r>& PreparedPolygon::getVertices() const{
+    return vertices;
+}
+
+const std::vector<Index>& PreparedPolygon::getIndices() const{
+    return indices;
+}
+
+unsigned int PreparedPolygon::getNumberEdges() const{
+    return indices.size();
+}
+
+bool PreparedPolygon::isCounterclockwise() const{
+    return counterclockwise;
+}
+
+bool PreparedPolygon::isPointBoundary(const Vector2r& point) const{
+    if (point.x < xMin || point.x > xMax || point.y < yMin || point.y > yMax){
+        return false;
+    }
+
+    // an edge that has the point on its boundary is in the cell of the point, the test is the one of
+    // Polygon::isPointBoundaryConcavePolygon
+    const unsigned int numberEdges = getNumberEdges();
+    const unsigned int c = getCellY(point.y) * numberCellsX + getCellX(point.x);
+    for (unsigned int e = cellStart[c]; e < cellStart[c + 1]; e++){
+        const unsigned int i = cellEdges[e];
+        const Vector2r& first = vertices[indices[i]];
+        const Vector2r& second = vertices[indices[(i + 1) % numberEdges]];
+        if (point == first || point == second){
+            return true;
+        }
+        Intersector inter;
+        inter.setSegment1(first, second);
+        inter.setSegment2(first, point);
+        if (inter.calculateRelativePosition() == RelativePosition::Parallel){
+            const Vector2r diffVertices = second - first;
+            const Vector2r diffIntersection = point - first;
+            if (diffVertices.dot(diffIntersection) > 0.0 &&
+                Vector2r::IsFirstDoubleGreater(diffVertices.normSquared(), diffIntersection.normSquared())){
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool PreparedPolygon::isPointInside(const Vector2r& point) const{
+    QueryBuffers buffers;
+    return isPointInside(point, buffers);
+}
+
+bool PreparedPolygon::isPointInside(const Vector2r& point, QueryBuffers& buffers) const{
+    unsigned int numberPositive = 0;
+    unsigned int numberNegative = 0;
+
+    const Vector2r& firstVector = {1, 1};
+
+    if (point == firstVector){
+        LOG(LogLevel::WARN) << "PreparedPolygon::isPointInside: point is on vertex";
+        return true;
+    }
+
+    Intersector inter;
+
+    inter.setSegment1(point, firstVector);
+
+    const Vector2r reference = firstVector - point;
+
+    // only the edges in the cells the line passes through can be intersected,
+    // each of them is counted as in Polygon::isPointInsideConcavePolygon
+    std::vector<unsigned int>& candidates = buffers.candidates;
+    candidates.clear();
+    getLineEdges(point, reference, candidates, buffers.cells);
+
+    const unsigned int numberCandidates = candidates.size();
+    Intersector::CreateEdgeArrays(edges, candidates, buffers.candidateEdges);
+    std::vector<LineSegmentIntersection>& intersectionTypes = buffers.intersectionTypes;
+    std::vector<Vector2r>& intersectionPoints = buffers.intersectionPoints;
+    inter.calculateLineSegmentIntersections(buffers.candidateEdges, intersectionTypes, intersectionPoints);
+
+    const unsigned int sizeIndices = getNumberEdges();
+    for (unsigned int c = 0; c < numberCandidates; c++){
+        const unsigned int i = candidates[c];
+        LineSegmentIntersection lineSegmentIntersection = intersectionTypes[c];
+
+        bool insideSegment = lineSegmentIntersection == LineSegmentIntersection::InsideSegment;
+        bool secondVertex = lineSegmentIntersection == LineSegmentIntersection::SecondVertex;
+        if (insideSegment || secondVertex){
+            const Vector2r intersectionPoint = intersectionPoints[c];
+            const Vector2r difference = intersectionPoint - point;
+
+            double dot = reference.dot(difference);
+
+            // check that intersection point is not isolated
+            if (secondVertex){
+                inter.setSegment2(intersectionPoint, vertices[indices[i]]);
+                RelativePosition beforeRelPos = inter.calculateRelativePosition();
+                inter.setSegment2(intersectionPoint, vertices[indices[(i + 2) % sizeIndices]]);
+                RelativePosition afterRelPos = inter.calculateRelativePosition();
+
+                if (beforeRelPos == afterRelPos ||
+                    beforeRelPos == RelativePosition::Parallel || afterRelPos == RelativePosition::Parallel){
+                    continue;
+                }
+            }
+
+            if (Vector2r::AreDoublesEqual(dot, 0.0)){
+                LOG(LogLevel::ERROR) << "dot is 0";
+            } else if (dot > 0){
+                numberPositive++;
+            } else if (dot < 0){
+                numberNegative++;
+            }
+        }
+    }
+
+    bool positiveEven = (numberPositive % 2) == 0;
+    bool negativeEven = (numberNegative % 2) == 0;
+
+    if (positiveEven && negativeEven){
+        return false;
+    } else if (!positiveEven && !negativeEven){
+        return true;
+    } else{
+        LOG(LogLevel::WARN) << "odd intersections";
+        return false;
+    }
+}
+
+bool PreparedPolygon::isPointInsideExact(const Vector2r& point) const{
+    if (getNumberEdges() == 0 || point.x > xMax || point.y < yMin || point.y > yMax){
+        return false;
+    }
+    // an edge crossed by the half line is in the cell of the crossing, which is in the row of the point
+    std::vector<unsigned int> candidates;
+    const unsigned int row = getCellY(point.y) * numberCellsX;
+    for (unsigned int x = getCellX(point.x); x < numberCellsX; x++){
+        candidates.insert(candidates.end(), cellEdges.begin() + cellStart[row + x], cellEdges.begin() + cellStart[row + x + 1]);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // an edge is crossed if its vertices are on different sides of the line (a vertex on it is above)
+    // and the point is on the left of the edge going up
+    bool inside = false;
+    for (unsigned int i : candidates){
+        const Vector2r first(edges.x1[i], edges.y1[i]);
+        const Vector2r second(edges.x2[i], edges.y2[i]);
+        if ((first.y >= point.y) != (second.y >= point.y)){
+            const int side = Predicates::Orient2d(first, second, point);
+            if ((second.y > first.y && side > 0) || (second.y < first.y && side < 0)){
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+void PreparedPolygon::getBoxEdges(double boxXMin, double boxYMin, double boxXMax, double boxYMax, std::vector<unsigned int>& boxEdges) const{
+    if (getNumberEdges() == 0 || boxXMax < xMin || boxXMin > xMax || boxYMax < yMin || boxYMin > yMax){
+        return;
+    }
+    // an edge is in every cell it passes through, so one that enters the box is in a cell the box covers
+    const unsigned int firstX = getCellX(boxXMin);
+    const unsigned int lastX = getCellX(boxXMax);
+    for (unsigned int y = getCellY(boxYMin); y <= getCellY(boxYMax); y++){
+        for (unsigned int x = firstX; x <= lastX; x++){
+            const unsigned int c = y * numberCellsX + x;
+            boxEdges.insert(boxEdges.end(), cellEdges.begin() + cellStart[c], cellEdges.begin() + cellStart[c + 1]);
+        }
+    }
+    std::sort(boxEdges.begin(), boxEdges.end());
+    boxEdges.erase(std::unique(boxEdges.begin(), boxEdges.end()), boxEdges.end());
+}
+
+const double PreparedPolygon::CELLS_PER_EDGE = 1.0;
+
+// PRIVATE
+
+unsigned int PreparedPolygon::getCellX(double x) const{
+    double cell = floor((x - xMin) / cellWidth);
+    if (!(cell > 0.0)){
+        return 0;
+    }
+    return (unsigned int)std::min(cell, (double)(numberCellsX - 1));
+}
+
+unsigned int PreparedPolygon::getCellY(double y) const{
+    double cell = floor((y - yMin) / cellHeight);
+    if (!(cell > 0.0)){
+        return 0;
+    }
+    return (unsigned int)std::min(cell, (double)(numberCellsY - 1));
+}
+
+void PreparedPolygon::getCells(double x1, double y1, double x2, double y2, double margin, std::vector<unsigned int>& cells) const{
+    // the segment is walked on the axis it moves more along, for every column (or row) the cells are the ones
+    // between the lowest and the highest point of the segment in the column, both grown by margin
+    const bool alongX = fabs(x2 - x1) >= fabs(y2 - y1);
+    const double mainFirst = alongX ? x1 : y1;
+    const double mainSecond = alongX ? x2 : y2;
+    const double otherFirst = alongX ? y1 : x1;
+    const double otherSecond = alongX ? y2 : x2;
+    const double mainLow = std::min(mainFirst, mainSecond);
+    const double mainHigh = std::max(mainFirst, mainSecond);
+    const double slope = mainHigh > mainLow ? (otherSecond - otherFirst) / (mainSecond - mainFirst) : 0.0;
+    const double mainMin = alongX ? xMin : yMin;
+    const double mainSize = alongX ? cellWidth : cellHeight;
+
+    const unsigned int first = alongX ? getCellX(mainLow - margin) : getCellY(mainLow - margin);
+    const unsigned int last = alongX ? getCellX(mainHigh + margin) : getCellY(mainHigh + margin);
+    for (unsigned int m = first; m <= last; m++){
+        // part of the segment that is less than margin away from the column
+        const double low = std::min(std::max(mainMin + m * mainSize - margin, mainLow), mainHigh);
+        const double high = std::max(std::min(mainMin + (m + 1) * mainSize + margin, mainHigh), mainLow);
+        const double otherLow = otherFirst + (low - mainFirst) * slope;
+        const double otherHigh = otherFirst + (high - mainFirst) * slope;
+        const double otherMin = std::min(otherLow, otherHigh) - margin;
+        const double otherMax = std::max(otherLow, otherHigh) + margin;
+        if (alongX){
+            for (unsigned int y = getCellY(otherMin); y <= getCellY(otherMax); y++){
+                cells.push_back(y * numberCellsX + m);
+            }
+        } else{
+            for (unsigned int x = getCellX(otherMin); x <= getCellX(otherMax); x++){
+                cells.push_back(m * numberCellsX + x);
+            }
+        }
+    }
+}
+
+void PreparedPolygon::getLineEdges(const Vector2r& point, const Vector2r& direction, std::vector<unsigned int>& candidates,
+                                   std::vector<unsigned int>& cells) const{
+    // the line is clipped to the bounding box, t goes along it from point in the direction
+    const double origins[2] = {point.x, point.y};
+    const double directions[2] = {direction.x, direction.y};
+    const double minimums[2] = {xMin, yMin};
+    const double maximums[2] = {xMax, yMax};
+    double tMin = -INFINITY;
+    double tMax = INFINITY;
+    for (unsigned int axis = 0; axis < 2; axis++){
+        if (directions[axis] == 0.0){
+            if (origins[axis] < minimums[axis] || origins[axis] > maximums[axis]){
+                return;
+            }
+            continue;
+        }
+        double t1 = (minimums[axis] - origins[axis]) / directions[axis];
+        double t2 = (maximums[axis] - origins[axis]) / directions[axis];
+        tMin = std::max(tMin, std::min(t1, t2));
+        tMax = std::min(tMax, std::max(t1, t2));
+    }
+    if (tMin > tMax){
+        return;
+    }
+
+    // edges are in the cells they are near to with a margin, so the line does not need one
+    cells.clear();
+    getCells(origins[0] + tMin * directions[0], origins[1] + tMin * directions[1],
+             origins[0] + tMax * directions[0], origins[1] + tMax * directions[1], 0.0, cells);
+    for (unsigned int c : cells){
+        candidates.insert(candidates.end(), cellEdges.begin() + cellStart[c], cellEdges.begin() + cellStart[c + 1]);
+    }
+
+    // an edge can be in more cells, it is counted once
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+double PreparedPolygon::GetMargin(const Vector2r& first, const Vector2r& second){
+    const double length = sqrt((second - first).normSquared());
+    // a point is on the boundary when the cross product is below the tolerance of parallelism, so it is at most
+    // tolerance / length from the line (the cross product is rounded to Real, it can be a bit more), and nearer than length to first
+    double boundary = 2.0 * (Intersector::TOLERANCE_PARALLELISM / std::max(length, 1.0E-30) + 1.0E-6 * length);
+    boundary = std::min(boundary, 2.0 * length);
+    // an intersection of the line is counted when (intersection - first) dot (intersection - second)
+    // is below the tolerance on vertex, the intersection is at most this far from the edge
+    const double tolerance = Intersector::TOLERANCE_ON_VERTEX;
+    const double intersection = 2.0 * (sqrt(length * length + 4.0 * tolerance) - length) / 2.0;
+    return std::max(boundary, intersection) + 1.0E-5;
+}
@@ -0,0 +1,91 @@
+#ifndef PREPAREDPOLYGON_H
+#define PREPAREDPOLYGON_H
+
+#include <vector>
+#include "Vector2.h"
+#include "Intersector.h"
+
+
+// polygon prepared for many point queries, as the border of a mesh checked against every piece of every element
+// the edges are put in the cells of a uniform grid over the bounding box, a query looks only at the edges
+// in the cells around the point (or along the line for isPointInside) instead of at all the edges
+// the answers are the same as Polygon::isPointBoundaryConcavePolygon and Polygon::isPointInsideConcavePolygon
+// it is never changed after it is built, so it can be shared by threads
+class PreparedPolygon{
+
+public:
+    PreparedPolygon();
+    PreparedPolygon(const std::vector<Vector2r>& _vertices, const std::vector<Index>& _indices);
+
+    PreparedPolygon(const PreparedPolygon&)                 = delete;
+    PreparedPolygon(PreparedPolygon&&) noexcept             = delete;
+    PreparedPolygon& operator=(const PreparedPolygon&)      = delete;
+    PreparedPolygon& operator=(PreparedPolygon&&) noexcept  = delete;
+
+    void build(const std::vector<Vector2r>& _vertices, const std::vector<Index>& _indices);
+
+    const std::vector<Vector2r>& getVertices() const;
+    const std::vector<Index>& getIndices() const;
+    unsigned int getNumberEdges() const;
+    // true if the vertices are anti-clockwise (or there are none)
+    bool isCounterclockwise() const;
+
+    // lists filled by isPointInside, kept by the caller so that many queries do not allocate them again
+    struct QueryBuffers{
+        std::vector<unsigned int> cells;
+        std::vector<unsigned int> candidates;
+        EdgeArrays candidateEdges;
+        std::vector<LineSegmentIntersection> intersectionTypes;
+        std::vector<Vector2r> intersectionPoints;
+    };
+
+    bool isPointBoundary(const Vector2r& point) const;
+    bool isPointInside(const Vector2r& point) const;
+    bool isPointInside(const Vector2r& point, QueryBuffers& buffers) const;
+    // even-odd test on the horizontal half line on the right of the point with exact predicates, without tolerance
+    // only the edges in the cells of the row of the point are looked at, the point must not be on the boundary
+    bool isPointInsideExact(const Vector2r& point) const;
+
+    // return: edges that can have a point inside the box, every edge once and in increasing order
+    // some of them can be outside, they are only the edges of the cells the box covers
+    void getBoxEdges(double boxXMin, double boxYMin, double boxXMax, double boxYMax, std::vector<unsigned int>& boxEdges) const;
+
+    // cells of the grid for each edge, on each axis
+    static const double CELLS_PER_EDGE;
+
+private:
+    std::vector<Vector2r> vertices;
+    std::vector<Index> indices;
+    // edge i goes from the vertex of index i to the next one
+    EdgeArrays edges;
+    bool counterclockwise;
+
+    // bounding box of the edges grown by their margins, nothing outside can be on the boundary or inside
+    double xMin;
+    double yMin;
+    double xMax;
+    double yMax;
+
+    unsigned int numberCellsX;
+    unsigned int numberCellsY;
+    double cellWidth;
+    double cellHeight;
+    // edges of cell (x, y) are cellEdges[cellStart[c]] up to cellEdges[cellStart[c + 1]], with c = y * numberCellsX + x
+    std::vector<unsigned int> cellStart;
+    std::vector<unsigned int> cellEdges;
+
+    unsigned int getCellX(double x) const;
+    unsigned int getCellY(double y) const;
+
+    // adds the cells that have a point less than margin away (on each axis) from the segment
+    void getCells(double x1, double y1, double x2, double y2, double margin, std::vector<unsigned int>& cells) const;
+
+    // return: edges that can be crossed by the line through point and Polygon::isPointInsideConcavePolygon's direction
+    void getLineEdges(const Vector2r& point, const Vector2r& direction, std::vector<unsigned int>& candidates,
+                      std::vector<unsigned int>& cells) const;
+
+    // distance from an edge a point can be and still be on the boundary (or be a vertex of an intersection)
+    static double GetMargin(const Vector2r& first, const Vector2r& second);
+};
+
+#endif // PREPAREDPOLYGON_H
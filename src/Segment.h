@@ -1,21 +1,21 @@
 #ifndef SEGMENT_H
 #define SEGMENT_H
 
-#include "Vector2f.h"
+#include "Vector2.h"
 
 
 class Segment{
 
 public:
-    Segment(const Vector2f& _s1, const Vector2f& _s2);
+    Segment(const Vector2r& _s1, const Vector2r& _s2);
 
-    const Vector2f getS1() const;
+    const Vector2r getS1() const;
 
-    const Vector2f getS2() const;
+    const Vector2r getS2() const;
 
 private:
-    Vector2f s1;
-    Vector2f s2;
+    Vector2r s1;
+    Vector2r s2;
 };
 
 #endif // SEGMENT_H
@@ -0,0 +1,135 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int _numberThreads) : numberThreads{_numberThreads}, currentTask{nullptr},
+                                                      generation{0}, workingThreads{0}, stopping{false} {
+    if (numberThreads == 0){
+        numberThreads = std::thread::hardware_concurrency();
+    }
+    if (numberThreads == 0){
+        numberThreads = 1;
+    }
+
+    for (unsigned int i = 0; i < numberThreads; i++){
+        queues.push_back(std::make_unique<Queue>());
+    }
+    // worker 0 is the thread calling run
+    for (unsigned int i = 1; i < numberThreads; i++){
+        threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+}
+
+unsigned int ThreadPool::getNumberThreads() const{
+    return numberThreads;
+}
+
+void ThreadPool::run(unsigned int numberTasks, const std::function<void(unsigned int)>& task){
+    if (numberTasks == 0){
+        return;
+    }
+
+    // every worker starts with a contiguous part of the indices
+    for (unsigned int w = 0; w < numberThreads; w++){
+        unsigned int begin = (unsigned long long)numberTasks * w / numberThreads;
+        unsigned int end = (unsigned long long)numberTasks * (w + 1) / numberThreads;
+        std::lock_guard<std::mutex> lock(queues[w]->mutex);
+        for (unsigned int i = begin; i < end; i++){
+            queues[w]->indices.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        exception = nullptr;
+        workingThreads = threads.size();
+        generation++;
+    }
+    started.notify_all();
+
+    runQueues(0);
+
+    std::exception_ptr thrown;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]{ return workingThreads == 0; });
+        currentTask = nullptr;
+        thrown = exception;
+        exception = nullptr;
+    }
+    if (thrown){
+        std::rethrow_exception(thrown);
+    }
+}
+
+void ThreadPool::work(unsigned int worker){
+    unsigned int seenGeneration = 0;
+    while (true){
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            started.wait(lock, [this, seenGeneration]{ return stopping || generation != seenGeneration; });
+            if (stopping){
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        runQueues(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            workingThreads--;
+            if (workingThreads == 0){
+                finished.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::runQueues(unsigned int worker){
+    unsigned int index;
+    while (pop(worker, index) || steal(worker, index)){
+        try{
+            (*currentTask)(index);
+        } catch (...){
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!exception){
+                exception = std::current_exception();
+            }
+        }
+    }
+}
+
+bool ThreadPool::pop(unsigned int worker, unsigned int& index){
+    Queue& queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.indices.empty()){
+        return false;
+    }
+    index = queue.indices.front();
+    queue.indices.pop_front();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned int worker, unsigned int& index){
+    for (unsigned int i = 1; i < numberThreads; i++){
+        Queue& queue = *queues[(worker + i) % numberThreads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.indices.empty()){
+            index = queue.indices.back();
+            queue.indices.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+
+// pool of threads that runs the same task on a range of indices
+// every worker has its own queue of indices and when it is empty it steals from the back of the others,
+// so a few slow tasks do not keep the other workers waiting
+// the thread calling run is the first worker, so a pool of 1 thread creates no thread at all
+class ThreadPool{
+
+public:
+    // 0 uses one thread for each core
+    ThreadPool(unsigned int _numberThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&)                 = delete;
+    ThreadPool(ThreadPool&&) noexcept             = delete;
+    ThreadPool& operator=(const ThreadPool&)      = delete;
+    ThreadPool& operator=(ThreadPool&&) noexcept  = delete;
+
+    unsigned int getNumberThreads() const;
+
+    // call task with every index from 0 to numberTasks - 1 and return when all are finished
+    // the first exception thrown by a task is thrown again here, after the other tasks are finished
+    // it cannot be called by a task
+    void run(unsigned int numberTasks, const std::function<void(unsigned int)>& task);
+
+private:
+    struct Queue{
+        std::mutex mutex;
+        std::deque<unsigned int> indices;
+    };
+
+    unsigned int numberThreads;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    // these are protected by mutex
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+    const std::function<void(unsigned int)>* currentTask;
+    // incremented every time run is called so the workers know there is something new to do
+    unsigned int generation;
+    unsigned int workingThreads;
+    bool stopping;
+    std::exception_ptr exception;
+
+    void work(unsigned int worker);
+    void runQueues(unsigned int worker);
+
+    // return: true if an index was taken, from the front of the worker queue or from the back of another one
+    bool pop(unsigned int worker, unsigned int& index);
+    bool steal(unsigned int worker, unsigned int& index);
+};
+
+#endif // THREADPOOL_H